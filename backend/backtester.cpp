@@ -0,0 +1,525 @@
+// backtester.cpp
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "backtester.hpp"
+#include "risk_management.hpp"
+#include "rng.hpp"
+#include "rolling_window.hpp"
+#include "hot_stats.hpp"
+
+using namespace std;
+
+namespace Backtester {
+
+constexpr uint64_t TICK_MAGIC   = 0x4b43495445474445ull; // "EDGETICK"
+constexpr uint32_t TICK_VERSION = 1;
+constexpr size_t   SYMBOL_BYTES = 12;
+constexpr double   NOTIONAL_PER_TRADE = 10000.0;
+
+static size_t symbolTableBytes(uint32_t n) {
+    return (n * SYMBOL_BYTES + 7) & ~(size_t)7;
+}
+
+/*===========================
+   Tick File
+===========================*/
+bool TickFile::open(const string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cout << "Error: Could not open tick file " << path << endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(FileHeader)) {
+        ::close(fd);
+        cout << "Error: " << path << " is not a tick file\n";
+        return false;
+    }
+    bytes = (size_t)st.st_size;
+    base = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        base = nullptr;
+        cout << "Error: Could not map " << path << endl;
+        return false;
+    }
+
+    // Sizes are checked by division so a forged tickCount cannot wrap the
+    // product, and every symbol index is checked once here so replays and
+    // the stub server can index the symbol table without bounds checks.
+    const FileHeader* hdr = static_cast<const FileHeader*>(base);
+    size_t tableEnd = sizeof(FileHeader) + symbolTableBytes(hdr->symbolCount);
+    bool valid = hdr->magic == TICK_MAGIC && hdr->version == TICK_VERSION && tableEnd <= bytes &&
+                 hdr->tickCount <= (bytes - tableEnd) / sizeof(Tick);
+    const Tick* first = reinterpret_cast<const Tick*>(static_cast<const char*>(base) + tableEnd);
+    for (uint64_t k = 0; valid && k < hdr->tickCount; k++)
+        valid = first[k].symbol < hdr->symbolCount;
+    if (!valid) {
+        cout << "Error: " << path << " is not a valid tick file\n";
+        close();
+        return false;
+    }
+
+    const char* sym = static_cast<const char*>(base) + sizeof(FileHeader);
+    for (uint32_t i = 0; i < hdr->symbolCount; i++, sym += SYMBOL_BYTES)
+        symbols.emplace_back(sym, strnlen(sym, SYMBOL_BYTES));
+    ticks = first;
+    count = hdr->tickCount;
+    madvise(base, bytes, MADV_SEQUENTIAL);
+    return true;
+}
+
+void TickFile::close() {
+    if (base) munmap(base, bytes);
+    base = nullptr;
+    ticks = nullptr;
+    count = 0;
+    symbols.clear();
+}
+
+bool writeTickFile(const string& path, const vector<string>& symbols, const vector<Tick>& ticks) {
+    ofstream out(path, ios::binary);
+    if (!out.is_open()) {
+        cout << "Error: Could not write " << path << endl;
+        return false;
+    }
+    FileHeader hdr{TICK_MAGIC, TICK_VERSION, (uint32_t)symbols.size(), ticks.size()};
+    out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+
+    vector<char> table(symbolTableBytes(hdr.symbolCount), 0);
+    for (size_t i = 0; i < symbols.size(); i++)
+        memcpy(&table[i * SYMBOL_BYTES], symbols[i].data(), min(symbols[i].size(), SYMBOL_BYTES - 1));
+    out.write(table.data(), table.size());
+    out.write(reinterpret_cast<const char*>(ticks.data()), ticks.size() * sizeof(Tick));
+    return (bool)out;
+}
+
+bool convertCSV(const string& csvPath, const string& outPath) {
+    ifstream in(csvPath);
+    if (!in.is_open()) {
+        cout << "Error: Could not open file " << csvPath << endl;
+        return false;
+    }
+
+    vector<string> symbols;
+    unordered_map<string, uint32_t> ids;
+    vector<Tick> ticks;
+    string line;
+    getline(in, line); // Skip header
+    size_t lineNo = 1, skipped = 0;
+
+    while (getline(in, line)) {
+        lineNo++;
+        stringstream ss(line);
+        string ts, sym, price;
+        getline(ss, ts, ',');
+        getline(ss, sym, ',');
+        getline(ss, price, ',');
+        if (sym.empty()) continue;
+
+        int64_t tsValue;
+        double priceValue;
+        try {
+            tsValue = stoll(ts);
+            priceValue = stod(price);
+        } catch (const exception&) {
+            // One bad row should not cost the whole file.
+            if (skipped++ < 10) cout << "Skipping line " << lineNo << ": bad timestamp or price\n";
+            continue;
+        }
+
+        auto it = ids.find(sym);
+        if (it == ids.end()) {
+            it = ids.emplace(sym, (uint32_t)symbols.size()).first;
+            symbols.push_back(sym);
+        }
+        ticks.push_back({tsValue, priceValue, it->second, 0});
+    }
+    if (skipped > 0) cout << "Skipped " << skipped << " malformed line(s) in " << csvPath << endl;
+    stable_sort(ticks.begin(), ticks.end(),
+                [](const Tick& a, const Tick& b) { return a.tsNanos < b.tsNanos; });
+    return writeTickFile(outPath, symbols, ticks);
+}
+
+string symbolName(uint32_t index, uint32_t count) {
+    size_t digits = max<size_t>(5, to_string(count > 0 ? count - 1 : 0).size());
+    string num = to_string(index);
+    return "T" + string(digits > num.size() ? digits - num.size() : 0, '0') + num;
+}
+
+bool generateTicks(const string& outPath, uint32_t symbolCount, uint64_t tickCount, uint64_t seed) {
+    if (symbolCount == 0) return false;
+    vector<string> symbols(symbolCount);
+    vector<double> price(symbolCount);
+    Random::SplitMix64 rng(seed);
+
+    for (uint32_t i = 0; i < symbolCount; i++) {
+        symbols[i] = symbolName(i, symbolCount);
+        price[i] = 20.0 + 480.0 * rng.uniform();
+    }
+
+    vector<Tick> ticks(tickCount);
+    for (uint64_t k = 0; k < tickCount; k++) {
+        uint32_t s = (uint32_t)rng.below(symbolCount);
+        // Symmetric step of up to ±0.5% keeps the walk driftless.
+        price[s] *= 1.0 + 0.01 * (rng.uniform() - 0.5);
+        ticks[k] = {(int64_t)k * 1000000, price[s], s, 0};
+    }
+    return writeTickFile(outPath, symbols, ticks);
+}
+
+/*===========================
+   Replay Engine
+===========================*/
+namespace {
+
+using RealTimeTrackerWithRisk::Alert;
+using ProfitLossModule::ProfitLoss;
+
+struct Position {
+    int quantity = 0;
+    double entry = 0, stop = 0, target = 0, last = 0;
+};
+
+// One parameter set replaying the tick stream: a tracker and a position per symbol.
+class Runner {
+private:
+    const vector<string>& symbols;
+    vector<ProfitLoss>* fills;
+    vector<RollingStats::Window> trackers;   // the live tracker's core, without its lock and counter
+    vector<Position> positions;
+    double stopFactor, targetFactor;
+
+    void fill(uint32_t sym, const char* type, int quantity, double price) {
+        ProfitLoss pl{symbols[sym], type, quantity, price};
+        ProfitLossModule::applyTrade(pl, result.totalInvestment, result.totalSellValue, +1);
+        if (fills) fills->push_back(pl);
+    }
+
+public:
+    Result result;
+
+    Runner(const TickFile& file, const Params& p, vector<ProfitLoss>* fillsOut)
+        : symbols(file.symbols), fills(fillsOut), positions(file.symbols.size()),
+          stopFactor(1.0 - p.stopLossPct / 100.0), targetFactor(1.0 + p.targetPct / 100.0) {
+        result.params = p;
+        trackers.assign(file.symbols.size(), RollingStats::Window(p.window));
+    }
+
+    void step(const Tick& t) {
+        if (!(t.price > 0) || !isfinite(t.price)) return;   // bad print: neither a signal nor a fill
+        RollingStats::Window& tracker = trackers[t.symbol];
+        Position& pos = positions[t.symbol];
+
+        // Signal uses the window before this tick, then the tick joins it.
+        bool ready = tracker.full();
+        double avg = tracker.average();
+        tracker.add(t.price);
+        pos.last = t.price;
+
+        if (pos.quantity > 0) {
+            Alert alert = RealTimeTrackerWithRisk::checkAlert(t.price, pos.stop, pos.target);
+            if (alert == Alert::None) return;
+            fill(t.symbol, "SELL", pos.quantity, t.price);
+            result.realized += pos.quantity * (t.price - pos.entry);
+            result.trades++;
+            if (alert == Alert::Target) result.targetsHit++;
+            else result.stopsHit++;
+            pos.quantity = 0;
+        } else if (ready && t.price > avg) {
+            // Clamped in double: a fraction-of-a-cent price must not overflow int.
+            pos.quantity = (int)clamp(floor(NOTIONAL_PER_TRADE / t.price), 1.0, (double)INT32_MAX);
+            pos.entry = t.price;
+            pos.stop = t.price * stopFactor;
+            pos.target = t.price * targetFactor;
+            fill(t.symbol, "BUY", pos.quantity, t.price);
+        }
+    }
+
+    void finish() {
+        for (const Position& pos : positions) {
+            if (pos.quantity == 0) continue;
+            result.openPositions++;
+            result.unrealized += pos.quantity * (pos.last - pos.entry);
+        }
+    }
+};
+
+constexpr size_t BLOCK_TICKS  = 4096;   // 96 KB of ticks, shared by a group
+constexpr size_t GROUP_PARAMS = 8;
+
+} // namespace
+
+// Replayed ticks are counted per run, not per tick, and apart from the live
+// trackers' investedge_ticks_total.
+static void countReplayed(uint64_t ticks) {
+    static const HotStats::Counter replayed = HotStats::counter(
+        "investedge_backtest_ticks_total", "",
+        "Ticks replayed by backtests, once per parameter set.");
+    replayed.inc(ticks);
+}
+
+Result runBacktest(const TickFile& file, const Params& params, vector<ProfitLoss>* fills) {
+    countReplayed(file.count);
+    Runner runner(file, params, fills);
+    for (size_t i = 0; i < file.count; i++) runner.step(file.ticks[i]);
+    runner.finish();
+    return runner.result;
+}
+
+vector<Result> runSweep(const TickFile& file, const vector<Params>& grid, unsigned threads) {
+    vector<Result> results(grid.size());
+    countReplayed((uint64_t)file.count * grid.size());
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    size_t groups = (grid.size() + GROUP_PARAMS - 1) / GROUP_PARAMS;
+    threads = (unsigned)min<size_t>(threads, max<size_t>(groups, 1));
+    atomic<size_t> nextGroup{0};
+
+    auto worker = [&]() {
+        for (size_t g; (g = nextGroup.fetch_add(1)) < groups;) {
+            size_t first = g * GROUP_PARAMS, last = min(first + GROUP_PARAMS, grid.size());
+            deque<Runner> runners;
+            for (size_t i = first; i < last; i++) runners.emplace_back(file, grid[i], nullptr);
+
+            for (size_t b = 0; b < file.count; b += BLOCK_TICKS) {
+                size_t e = min(b + BLOCK_TICKS, file.count);
+                for (Runner& r : runners)
+                    for (size_t i = b; i < e; i++) r.step(file.ticks[i]);
+            }
+            for (size_t i = first; i < last; i++) {
+                runners[i - first].finish();
+                results[i] = runners[i - first].result;
+            }
+        }
+    };
+
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    return results;
+}
+
+vector<Params> makeGrid(const vector<double>& stopLossPcts, const vector<double>& targetPcts,
+                        const vector<size_t>& windows) {
+    vector<Params> grid;
+    for (size_t w : windows)
+        for (double sl : stopLossPcts)
+            for (double tp : targetPcts)
+                grid.push_back({sl, tp, w});
+    return grid;
+}
+
+/*===========================
+   Reports
+===========================*/
+bool saveLedger(const string& path, const vector<ProfitLoss>& fills) {
+    ofstream file(path);
+    if (!file.is_open()) {
+        cout << "Error: Could not write " << path << endl;
+        return false;
+    }
+    file << "Stock Name,Type,Quantity,Price\n";
+    for (const ProfitLoss& pl : fills)
+        file << pl.stockname << "," << pl.type << "," << pl.quantity << "," << pl.price << "\n";
+    return true;
+}
+
+static vector<size_t> byPnl(const vector<Result>& results) {
+    vector<size_t> idx(results.size());
+    for (size_t i = 0; i < idx.size(); i++) idx[i] = i;
+    sort(idx.begin(), idx.end(), [&](size_t a, size_t b) { return results[a].pnl() > results[b].pnl(); });
+    return idx;
+}
+
+void printReport(const vector<Result>& results, size_t top) {
+    cout << "\nRank | Stop% | Target% | Window | Trades | Hit Rate |   Realized P&L | Unrealized | Open\n";
+    cout << "-----------------------------------------------------------------------------------------\n";
+    vector<size_t> idx = byPnl(results);
+    for (size_t r = 0; r < min(top, idx.size()); r++) {
+        const Result& res = results[idx[r]];
+        cout << right << setw(4) << r + 1 << " | "
+             << fixed << setprecision(2) << setw(5) << res.params.stopLossPct << " | "
+             << setw(7) << res.params.targetPct << " | "
+             << setw(6) << res.params.window << " | "
+             << setw(6) << res.trades << " | "
+             << setw(7) << res.hitRate() * 100.0 << "% | "
+             << setw(14) << res.realized << " | "
+             << setw(10) << res.unrealized << " | "
+             << res.openPositions << "\n";
+    }
+}
+
+bool saveReportCSV(const string& path, const vector<Result>& results) {
+    ofstream out(path);
+    if (!out.is_open()) {
+        cout << "Error: Could not write " << path << endl;
+        return false;
+    }
+    out << "stop_loss_pct,target_pct,window,trades,targets_hit,stops_hit,hit_rate,"
+           "total_investment,total_sell_value,realized_pnl,unrealized_pnl,open_positions\n";
+    for (size_t i : byPnl(results)) {
+        const Result& r = results[i];
+        out << r.params.stopLossPct << "," << r.params.targetPct << "," << r.params.window << ","
+            << r.trades << "," << r.targetsHit << "," << r.stopsHit << "," << r.hitRate() << ","
+            << fixed << setprecision(2) << r.totalInvestment << "," << r.totalSellValue << ","
+            << r.realized << "," << r.unrealized << "," << r.openPositions << "\n";
+        out.unsetf(ios::fixed);
+    }
+    return true;
+}
+
+/*===========================
+   Entry Points
+===========================*/
+template <typename T>
+static vector<T> parseList(const string& s) {
+    vector<T> out;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty()) out.push_back((T)stod(item));
+    return out;
+}
+
+static void sweep(const string& tickPath, const vector<Params>& grid, unsigned threads,
+                  const string& reportPath, const string& ledgerPath) {
+    TickFile file;
+    if (!file.open(tickPath)) return;
+    if (grid.empty()) {
+        cout << "Empty parameter grid.\n";
+        return;
+    }
+    cout << "Replaying " << file.count << " ticks (" << file.symbols.size() << " symbols) through "
+         << grid.size() << " parameter sets...\n";
+
+    auto t0 = chrono::steady_clock::now();
+    vector<Result> results = runSweep(file, grid, threads);
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    printReport(results);
+    double total = (double)file.count * grid.size();
+    cout << "\nProcessed " << fixed << setprecision(0) << total << " ticks in "
+         << setprecision(3) << secs << " s ("
+         << setprecision(1) << total / secs / 1e6 << " M ticks/s)\n";
+
+    if (!reportPath.empty() && saveReportCSV(reportPath, results))
+        cout << "Report written to " << reportPath << "\n";
+
+    if (!ledgerPath.empty()) {
+        const Result& best = results[byPnl(results).front()];
+        vector<ProfitLossModule::ProfitLoss> fills;
+        runBacktest(file, best.params, &fills);
+        if (saveLedger(ledgerPath, fills))
+            cout << "Ledger of best parameter set (" << fills.size() << " fills) written to "
+                 << ledgerPath << "\n";
+    }
+}
+
+void run(const vector<string>& args) {
+    if (args.empty()) {
+        run();
+        return;
+    }
+
+    string cmd = args[0], ticks, out, report, ledger;
+    vector<double> stops = {1, 2, 3}, targets = {2, 4, 6};
+    vector<size_t> windows = {10, 50};
+    uint32_t symbols = 100;
+    uint64_t count = 10000000;
+    unsigned threads = 0;
+
+    for (size_t i = 1; i < args.size(); i++) {
+        const string& a = args[i];
+        size_t eq = a.find('=');
+        string key = a.substr(0, eq), val = eq == string::npos ? "" : a.substr(eq + 1);
+        if (key == "--ticks") ticks = val;
+        else if (key == "--out") out = val;
+        else if (key == "--report") report = val;
+        else if (key == "--ledger") ledger = val;
+        else if (key == "--stop") stops = parseList<double>(val);
+        else if (key == "--target") targets = parseList<double>(val);
+        else if (key == "--window") windows = parseList<size_t>(val);
+        else if (key == "--symbols") symbols = (uint32_t)stoul(val);
+        else if (key == "--count") count = stoull(val);
+        else if (key == "--threads") threads = (unsigned)stoul(val);
+        else if (cmd == "convert" && ticks.empty()) ticks = a;
+        else if (cmd == "convert" && out.empty()) out = a;
+        else { cout << "Unknown option " << a << "\n"; return; }
+    }
+
+    if (cmd == "generate") {
+        if (out.empty()) out = "ticks.bin";
+        if (generateTicks(out, symbols, count))
+            cout << "Wrote " << count << " ticks for " << symbols << " symbols to " << out << "\n";
+    } else if (cmd == "convert") {
+        if (convertCSV(ticks, out)) cout << "Converted " << ticks << " to " << out << "\n";
+    } else if (cmd == "sweep") {
+        sweep(ticks, makeGrid(stops, targets, windows), threads, report, ledger);
+    } else {
+        cout << "Usage:\n"
+             << "  backtester generate --out=ticks.bin [--symbols=100] [--count=10000000]\n"
+             << "  backtester convert ticks.csv ticks.bin\n"
+             << "  backtester sweep --ticks=ticks.bin [--stop=1,2,3] [--target=2,4,6] [--window=10,50]\n"
+             << "                   [--threads=N] [--report=sweep.csv] [--ledger=History.csv]\n";
+    }
+}
+
+void run() {
+    while (true) {
+        cout << "\n=========== Backtester ===========\n";
+        cout << "1. Generate Synthetic Ticks\n";
+        cout << "2. Convert CSV Ticks\n";
+        cout << "3. Run Parameter Sweep\n";
+        cout << "0. Exit\n";
+        cout << "----------------------------------\n";
+        cout << "Enter choice: ";
+
+        int ch;
+        if (!(cin >> ch) || ch == 0) break;
+
+        if (ch == 1) {
+            string out;
+            uint32_t symbols;
+            uint64_t count;
+            cout << "Output file: "; cin >> out;
+            cout << "Symbols: "; cin >> symbols;
+            cout << "Ticks: "; cin >> count;
+            if (generateTicks(out, symbols, count)) cout << "Wrote " << count << " ticks to " << out << "\n";
+        } else if (ch == 2) {
+            string in, out;
+            cout << "CSV file (timestamp,symbol,price): "; cin >> in;
+            cout << "Output file: "; cin >> out;
+            if (convertCSV(in, out)) cout << "Converted " << in << " to " << out << "\n";
+        } else if (ch == 3) {
+            string file, sl, tp, win;
+            cout << "Tick file: "; cin >> file;
+            cout << "Stop-loss % list (e.g. 1,2,3): "; cin >> sl;
+            cout << "Target % list (e.g. 2,4,6): "; cin >> tp;
+            cout << "Window sizes (e.g. 10,50): "; cin >> win;
+            sweep(file, makeGrid(parseList<double>(sl), parseList<double>(tp), parseList<size_t>(win)),
+                  0, "", "");
+        } else {
+            cout << "Invalid choice! Try again.\n";
+        }
+    }
+}
+
+} // namespace Backtester
@@ -0,0 +1,121 @@
+// backtester.hpp
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "profit_loss.hpp"
+
+namespace Backtester {
+
+/*===========================
+   Tick File
+===========================*/
+// Binary layout: FileHeader, symbolCount × 12-byte NUL-padded symbols
+// (padded to 8 bytes), then tickCount × Tick in replay order.
+struct Tick {
+    int64_t  tsNanos;
+    double   price;
+    uint32_t symbol;      // index into the symbol table
+    uint32_t reserved;
+};
+static_assert(sizeof(Tick) == 24, "Tick must stay 24 bytes");
+
+struct FileHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t symbolCount;
+    uint64_t tickCount;
+};
+
+// Read-only memory mapping of a tick file.
+class TickFile {
+private:
+    void* base = nullptr;
+    size_t bytes = 0;
+
+public:
+    std::vector<std::string> symbols;
+    const Tick* ticks = nullptr;
+    size_t count = 0;
+
+    TickFile() = default;
+    TickFile(const TickFile&) = delete;
+    TickFile& operator=(const TickFile&) = delete;
+    ~TickFile() { close(); }
+
+    bool open(const std::string& path);
+    void close();
+};
+
+bool writeTickFile(const std::string& path, const std::vector<std::string>& symbols,
+                   const std::vector<Tick>& ticks);
+
+// CSV with header "timestamp,symbol,price"; timestamps are any integer unit.
+bool convertCSV(const std::string& csvPath, const std::string& outPath);
+
+// Name of generated symbol `index` of `count`: "T" plus the index zero-padded
+// to at least 5 digits, wider when the count needs it, so names stay unique
+// and sort in index order (T00042, or T0000042 for 10M symbols).
+std::string symbolName(uint32_t index, uint32_t count);
+
+// Random-walk ticks for `symbolCount` symbols (named by symbolName),
+// interleaved in time order.
+bool generateTicks(const std::string& outPath, uint32_t symbolCount, uint64_t tickCount,
+                   uint64_t seed = 42);
+
+/*===========================
+   Strategy Parameters & Results
+===========================*/
+// Enter long when a price breaks above the rolling average of the last
+// `window` prices; exit on the same stop-loss/target alert rule as the live
+// RealTimeTrackerWithRisk, with thresholds set as % below/above the entry.
+struct Params {
+    double stopLossPct;
+    double targetPct;
+    size_t window;
+};
+
+struct Result {
+    Params params;
+    uint64_t trades = 0;          // closed round trips
+    uint64_t targetsHit = 0;
+    uint64_t stopsHit = 0;
+    double totalInvestment = 0;   // ledger totals, as in ProfitLossModule
+    double totalSellValue = 0;
+    double realized = 0;          // P&L of closed trades
+    double unrealized = 0;        // open positions marked at their last price
+    uint64_t openPositions = 0;
+
+    double hitRate() const { return trades ? (double)targetsHit / trades : 0.0; }
+    double pnl() const { return realized + unrealized; }
+};
+
+// Replays every tick through one parameter set. When `fills` is given, each
+// simulated BUY/SELL is appended as a ProfitLossModule ledger entry.
+Result runBacktest(const TickFile& file, const Params& params,
+                   std::vector<ProfitLossModule::ProfitLoss>* fills = nullptr);
+
+// Runs all parameter sets across `threads` workers (0 = all cores). Each
+// worker replays tick blocks through a group of parameter sets at a time so
+// the block stays in cache.
+std::vector<Result> runSweep(const TickFile& file, const std::vector<Params>& grid,
+                             unsigned threads = 0);
+
+std::vector<Params> makeGrid(const std::vector<double>& stopLossPcts,
+                             const std::vector<double>& targetPcts,
+                             const std::vector<size_t>& windows);
+
+// Writes fills in the History.csv layout that ProfitLossModule loads.
+bool saveLedger(const std::string& path, const std::vector<ProfitLossModule::ProfitLoss>& fills);
+
+void printReport(const std::vector<Result>& results, size_t top = 20);
+bool saveReportCSV(const std::string& path, const std::vector<Result>& results);
+
+/*===========================
+   Entry Points
+===========================*/
+void run(const std::vector<std::string>& args);   // CLI mode
+void run();                                        // interactive menu
+
+} // namespace Backtester
@@ -0,0 +1,45 @@
+// backtester_bench.cpp
+// Replay throughput of the backtesting engine on synthetic random-walk ticks
+// (default 2M ticks over 100 symbols): one parameter set single-threaded,
+// then a 27-set grid sweep on 1 thread and on all cores. ops are ticks ×
+// parameter sets.
+#include <string>
+#include <thread>
+#include "bench_common.hpp"
+#include "backtester.hpp"
+
+using namespace std;
+namespace BT = Backtester;
+
+int main(int argc, char** argv) {
+    Bench::Options opt = Bench::parseOptions(argc, argv);
+    Bench::Reporter rep("backtester");
+    Bench::TempDir tmp;
+
+    vector<BT::Params> grid = BT::makeGrid({1, 2, 3}, {2, 4, 6}, {10, 50, 200});
+    unsigned cores = max(1u, thread::hardware_concurrency());
+
+    for (uint64_t n : opt.sizesOr({2000000})) {
+        cerr << "replaying " << n << " ticks\n";
+        if (!BT::generateTicks("ticks.bin", 100, n)) return 1;
+        BT::TickFile file;
+        if (!file.open("ticks.bin")) return 1;
+
+        Bench::Reporter::Params p = {{"ticks", to_string(n)}, {"symbols", "100"}};
+        auto t = Bench::measure([&] { Bench::doNotOptimize(BT::runBacktest(file, grid[0]).pnl()); },
+                                opt.minSeconds, 100);
+        rep.add("runBacktest", p, t, (double)n);
+
+        for (unsigned threads : {1u, cores}) {
+            Bench::Reporter::Params sp = p;
+            sp.push_back({"param_sets", to_string(grid.size())});
+            sp.push_back({"threads", to_string(threads)});
+            t = Bench::measure([&] { Bench::doNotOptimize(BT::runSweep(file, grid, threads).size()); },
+                               opt.minSeconds, 100);
+            rep.add("runSweep", sp, t, (double)n * grid.size());
+        }
+    }
+
+    rep.write(opt);
+    return 0;
+}
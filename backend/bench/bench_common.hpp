@@ -0,0 +1,319 @@
+// bench_common.hpp
+// Shared helpers for the backend benchmarks: a deterministic RNG, synthetic
+// data generators, a timing loop and a JSON reporter. Every benchmark prints
+// one JSON document (to stdout or --out=FILE) so results can be diffed
+// between releases; progress notes go to stderr.
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "rng.hpp"
+
+namespace Bench {
+
+/*===========================
+   Deterministic RNG
+===========================*/
+// Same generator the modules use for their own synthetic data.
+using Rng = Random::SplitMix64;
+
+/*===========================
+   Synthetic Data Generators
+===========================*/
+inline const std::vector<std::string>& sectors() {
+    static const std::vector<std::string> s = {
+        "IT", "Technology", "Banking", "Automotive", "Pharma", "Energy",
+        "FMCG", "Metals", "Telecom", "Realty", "Infrastructure", "Media"};
+    return s;
+}
+
+inline std::string symbolFor(uint64_t i) {
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "S%07llu", (unsigned long long)i);
+    return buf;
+}
+
+// portfolio.csv layout: symbol,name,sector,price,prev_close,market_cap
+inline void writeUniverseCSV(const std::string& path, uint64_t n, uint64_t seed = 42) {
+    Rng rng(seed);
+    std::ofstream out(path);
+    out << "symbol,name,sector,price,prev_close,market_cap\n";
+    char line[160];
+    for (uint64_t i = 0; i < n; i++) {
+        double prev = std::exp(rng.uniform(std::log(5.0), std::log(5000.0)));
+        double price = prev * (1.0 + 0.03 * rng.normal());
+        double cap = std::exp(rng.uniform(std::log(1e4), std::log(2e7)));
+        const std::string& sector = sectors()[rng.below(sectors().size())];
+        std::snprintf(line, sizeof(line), "%s,Company %llu,%s,%.2f,%.2f,%.0f\n",
+                      symbolFor(i).c_str(), (unsigned long long)i, sector.c_str(),
+                      price, prev, cap);
+        out << line;
+    }
+}
+
+// History.csv layout: Stock Name,Type,Quantity,Price
+inline void writeTradeHistoryCSV(const std::string& path, uint64_t rows,
+                                 uint64_t universe = 5000, uint64_t seed = 7) {
+    Rng rng(seed);
+    std::ofstream out(path);
+    out << "Stock Name,Type,Quantity,Price\n";
+    char line[96];
+    for (uint64_t i = 0; i < rows; i++) {
+        std::snprintf(line, sizeof(line), "%s,%s,%d,%.2f\n",
+                      symbolFor(rng.below(universe)).c_str(),
+                      rng.below(2) ? "BUY" : "SELL",
+                      1 + (int)rng.below(500), rng.uniform(5.0, 5000.0));
+        out << line;
+    }
+}
+
+// Geometric random walk of n prices starting at `start`.
+inline std::vector<double> makeTickStream(uint64_t n, double start = 100.0,
+                                          double vol = 0.001, uint64_t seed = 11) {
+    Rng rng(seed);
+    std::vector<double> ticks(n);
+    double p = start;
+    for (uint64_t i = 0; i < n; i++) {
+        p *= 1.0 + vol * rng.normal();
+        ticks[i] = p;
+    }
+    return ticks;
+}
+
+// Twelve Data /price response.
+inline std::string pricePayload(double price) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "{\"price\":\"%.5f\"}", price);
+    return buf;
+}
+
+// NewsAPI /v2/everything response with `articles` entries.
+inline std::string newsPayload(int articles, uint64_t seed = 3) {
+    Rng rng(seed);
+    std::ostringstream out;
+    out << "{\"status\":\"ok\",\"totalResults\":" << articles << ",\"articles\":[";
+    for (int i = 0; i < articles; i++) {
+        if (i) out << ",";
+        out << "{\"source\":{\"id\":null,\"name\":\"Wire " << rng.below(20) << "\"},"
+            << "\"author\":" << (rng.below(4) ? "\"Reporter " + std::to_string(rng.below(100)) + "\"" : "null") << ","
+            << "\"title\":\"Markets move as sector " << sectors()[rng.below(sectors().size())]
+            << " rallies on earnings, headline " << i << "\","
+            << "\"description\":\"Synthetic summary text for benchmarking the news parser. "
+            << "Analysts expect volatility to remain elevated through the quarter.\","
+            << "\"url\":\"https://example.com/news/" << i << "\","
+            << "\"urlToImage\":null,"
+            << "\"publishedAt\":\"2024-01-" << 10 + i % 18 << "T09:30:00Z\","
+            << "\"content\":\"Lorem ipsum dolor sit amet, consectetur adipiscing elit.\"}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+/*===========================
+   Output Helpers
+===========================*/
+// Swallows everything written to std::cout while in scope, so benchmarks
+// measure the formatting work of the UI functions without a terminal.
+class SilenceCout {
+    struct NullBuf : std::streambuf {
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    } nullBuf;
+    std::streambuf* saved;
+public:
+    SilenceCout() : saved(std::cout.rdbuf(&nullBuf)) {}
+    ~SilenceCout() { std::cout.rdbuf(saved); }
+};
+
+// Runs the benchmark inside a fresh temporary directory.
+class TempDir {
+    std::string path, prev;
+public:
+    TempDir() {
+        char tmpl[] = "/tmp/investedge_bench_XXXXXX";
+        char buf[4096];
+        prev = getcwd(buf, sizeof(buf)) ? buf : ".";
+        if (!mkdtemp(tmpl)) { std::perror("mkdtemp"); std::exit(1); }
+        path = tmpl;
+        if (chdir(path.c_str()) != 0) { std::perror("chdir"); std::exit(1); }
+    }
+    ~TempDir() {
+        if (chdir(prev.c_str()) != 0) std::perror("chdir");
+        std::string cmd = "rm -rf '" + path + "'";
+        if (std::system(cmd.c_str()) != 0) std::cerr << "could not remove " << path << "\n";
+    }
+    const std::string& dir() const { return path; }
+};
+
+/*===========================
+   Timing
+===========================*/
+struct Timing {
+    uint64_t iterations;
+    double seconds;       // total over all iterations
+};
+
+// Repeats fn until `minSeconds` have elapsed (at least once, at most
+// maxIterations). `setup` runs before each iteration and is not timed.
+inline Timing measure(const std::function<void()>& fn, double minSeconds = 0.3,
+                      uint64_t maxIterations = 1000000,
+                      const std::function<void()>& setup = nullptr) {
+    Timing t{0, 0.0};
+    while (t.iterations < maxIterations && (t.iterations == 0 || t.seconds < minSeconds)) {
+        if (setup) setup();
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        auto t1 = std::chrono::steady_clock::now();
+        t.seconds += std::chrono::duration<double>(t1 - t0).count();
+        t.iterations++;
+    }
+    return t;
+}
+
+// Keeps a computed value alive so the optimizer cannot drop the work.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+/*===========================
+   Command Line
+===========================*/
+struct Options {
+    std::string out;                 // --out=FILE (default stdout)
+    std::vector<uint64_t> sizes;     // --sizes=1000,100000
+    double minSeconds = 0.3;         // --min-time=SECONDS
+
+    std::vector<uint64_t> sizesOr(std::vector<uint64_t> defaults) const {
+        return sizes.empty() ? defaults : sizes;
+    }
+};
+
+inline Options parseOptions(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a.rfind("--out=", 0) == 0) {
+            o.out = a.substr(6);
+            char cwd[4096];   // benchmarks chdir into a TempDir; pin the path now
+            if (!o.out.empty() && o.out[0] != '/' && getcwd(cwd, sizeof(cwd)))
+                o.out = std::string(cwd) + "/" + o.out;
+        }
+        else if (a.rfind("--min-time=", 0) == 0) o.minSeconds = std::atof(a.c_str() + 11);
+        else if (a.rfind("--sizes=", 0) == 0) {
+            std::stringstream ss(a.substr(8));
+            std::string item;
+            while (std::getline(ss, item, ','))
+                if (!item.empty()) o.sizes.push_back((uint64_t)std::atof(item.c_str()));
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--out=FILE] [--sizes=N,N,...] [--min-time=S]\n";
+            std::exit(2);
+        }
+    }
+    return o;
+}
+
+/*===========================
+   JSON Reporter
+===========================*/
+class Reporter {
+public:
+    using Params = std::vector<std::pair<std::string, std::string>>;
+
+private:
+    struct Row {
+        std::string name;
+        Params params;
+        Timing timing;
+        double opsPerIteration;
+        std::vector<std::pair<std::string, double>> extra;
+    };
+    std::string suite;
+    std::vector<Row> rows;
+
+    static std::string escape(const std::string& s) {
+        std::string r;
+        for (char c : s) {
+            if (c == '"' || c == '\\') { r += '\\'; r += c; }
+            else if ((unsigned char)c < 0x20) { char b[8]; std::snprintf(b, sizeof(b), "\\u%04x", c); r += b; }
+            else r += c;
+        }
+        return r;
+    }
+    static std::string number(double v) {
+        if (!std::isfinite(v)) return "null";
+        char b[32];
+        std::snprintf(b, sizeof(b), "%.6g", v);
+        return b;
+    }
+
+public:
+    explicit Reporter(std::string suiteName) : suite(std::move(suiteName)) {}
+
+    // opsPerIteration: how many logical operations one timed iteration did
+    // (e.g. rows loaded, ticks added); ns_per_op and ops_per_sec use it.
+    void add(const std::string& name, const Params& params, const Timing& t,
+             double opsPerIteration = 1.0,
+             std::vector<std::pair<std::string, double>> extra = {}) {
+        rows.push_back({name, params, t, opsPerIteration, std::move(extra)});
+        double perOp = t.seconds / t.iterations / opsPerIteration;
+        std::cerr << "  " << name;
+        for (auto& p : params) std::cerr << " " << p.first << "=" << p.second;
+        std::cerr << ": " << perOp * 1e9 << " ns/op\n";
+    }
+
+    void write(std::ostream& out) const {
+        char stamp[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        out << "{\n  \"suite\": \"" << escape(suite) << "\",\n"
+            << "  \"timestamp\": \"" << stamp << "\",\n"
+            << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+#if defined(__clang__)
+            << "  \"compiler\": \"clang " << __clang_version__ << "\",\n"
+#elif defined(__GNUC__)
+            << "  \"compiler\": \"gcc " << __VERSION__ << "\",\n"
+#endif
+            << "  \"results\": [";
+        for (size_t i = 0; i < rows.size(); i++) {
+            const Row& r = rows[i];
+            double totalOps = r.opsPerIteration * r.timing.iterations;
+            out << (i ? "," : "") << "\n    {\"name\": \"" << escape(r.name) << "\", \"params\": {";
+            for (size_t k = 0; k < r.params.size(); k++)
+                out << (k ? ", " : "") << "\"" << escape(r.params[k].first) << "\": \""
+                    << escape(r.params[k].second) << "\"";
+            out << "}, \"iterations\": " << r.timing.iterations
+                << ", \"total_seconds\": " << number(r.timing.seconds)
+                << ", \"ns_per_op\": " << number(r.timing.seconds * 1e9 / totalOps)
+                << ", \"ops_per_sec\": " << number(totalOps / r.timing.seconds);
+            for (auto& e : r.extra) out << ", \"" << escape(e.first) << "\": " << number(e.second);
+            out << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    void write(const Options& o) const {
+        if (o.out.empty()) { write(std::cout); return; }
+        std::ofstream f(o.out);
+        if (!f) { std::cerr << "Cannot write " << o.out << "\n"; std::exit(1); }
+        write(f);
+    }
+};
+
+} // namespace Bench
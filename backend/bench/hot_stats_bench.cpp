@@ -0,0 +1,130 @@
+// hot_stats_bench.cpp
+// Cost of the HotStats primitives and the instrumentation overhead on the
+// tracker hot path: addPrice built as shipped vs. the same translation unit
+// built with INVESTEDGE_NO_STATS (the hot_stats_overhead probes).
+#include <string>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <limits.h>
+#include "bench_common.hpp"
+#include "hot_stats.hpp"
+
+using namespace std;
+
+static string exeDir() {
+    char buf[PATH_MAX];
+    ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+    if (n <= 0) return ".";
+    string path(buf, (size_t)n);
+    return path.substr(0, path.rfind('/'));
+}
+
+// Best-of-reps addPrice seconds from one probe run, or -1 if it failed.
+static double runProbe(const string& probe, uint64_t ticks, size_t window, bool withRisk) {
+    string cmd = exeDir() + "/" + probe + " --ticks=" + to_string(ticks) +
+                 " --window=" + to_string(window) + (withRisk ? " --risk" : "");
+    FILE* p = popen(cmd.c_str(), "r");
+    if (!p) return -1;
+    double seconds = -1;
+    if (fscanf(p, "%lf", &seconds) != 1) seconds = -1;
+    return pclose(p) == 0 ? seconds : -1;
+}
+
+// 1-based rank k such that [x(k), x(n+1-k)] covers the median of n paired
+// samples with at least 95% confidence (binomial order statistics).
+static size_t medianConfidenceRank(size_t n) {
+    double tail = pow(0.5, (double)n), cdf = tail;        // P(B(n, 1/2) <= j)
+    size_t k = 0;
+    for (size_t j = 0; j < n / 2 && cdf <= 0.025; j++) {
+        k = j + 1;
+        tail *= (double)(n - j) / (double)(j + 1);
+        cdf += tail;
+    }
+    return max<size_t>(k, 1);
+}
+
+int main(int argc, char** argv) {
+    Bench::Options opt = Bench::parseOptions(argc, argv);
+    Bench::Reporter rep("hot_stats");
+
+    // ---- Primitives
+    const int OPS = 1000000;
+    HotStats::Counter c = HotStats::counter("bench_counter_total", "", "bench");
+    HotStats::Histogram h = HotStats::histogram("bench_latency_seconds", "", "bench");
+
+    auto t = Bench::measure([&] { for (int i = 0; i < OPS; i++) c.inc(); }, opt.minSeconds);
+    rep.add("Counter::inc", {}, t, OPS);
+
+    HotStats::LocalCounter local(c);
+    auto tl = Bench::measure([&] { for (int i = 0; i < OPS; i++) local.inc(); }, opt.minSeconds);
+    rep.add("LocalCounter::inc", {}, tl, OPS);
+
+    t = Bench::measure([&] { for (int i = 0; i < OPS; i++) h.record((uint64_t)i * 37); }, opt.minSeconds);
+    rep.add("Histogram::record", {}, t, OPS);
+
+    t = Bench::measure([&] { for (int i = 0; i < OPS; i++) { HotStats::ScopedTimer s(h); } }, opt.minSeconds);
+    rep.add("ScopedTimer", {}, t, OPS);
+
+    // ---- Merge on read with several writer threads alive
+    for (int threads : {1, 8}) {
+        vector<thread> pool;
+        atomic<bool> stop{false};
+        for (int i = 0; i < threads; i++)
+            pool.emplace_back([&] {
+                while (!stop.load(memory_order_relaxed)) { c.inc(); h.record(1000); this_thread::yield(); }
+            });
+        t = Bench::measure([] { HotStats::collect(); }, opt.minSeconds);
+        rep.add("collect", {{"writer_threads", to_string(threads)}}, t, 1);
+        t = Bench::measure([] { ostringstream out; HotStats::writePrometheus(out); }, opt.minSeconds);
+        rep.add("writePrometheus", {{"writer_threads", to_string(threads)}}, t, 1);
+        stop = true;
+        for (auto& th : pool) th.join();
+    }
+
+    // ---- Overhead on the tracker hot path. Each round runs both probes, in
+    // alternating order, and yields one paired ratio; the median ratio and
+    // its 95% confidence interval are reported against the 1% budget.
+    const int ROUNDS = 31;
+    const double BUDGET_PERCENT = 1.0;
+    uint64_t ticks = opt.sizesOr({1000000})[0];
+    for (bool withRisk : {false, true}) {
+        for (size_t window : {10, 1000}) {
+            double best = 1e30, bestBase = 1e30;
+            vector<double> ratios;
+            for (int round = 0; round < ROUNDS; round++) {
+                double base, inst;
+                if (round % 2) {
+                    base = runProbe("hot_stats_overhead_nostats", ticks, window, withRisk);
+                    inst = runProbe("hot_stats_overhead", ticks, window, withRisk);
+                } else {
+                    inst = runProbe("hot_stats_overhead", ticks, window, withRisk);
+                    base = runProbe("hot_stats_overhead_nostats", ticks, window, withRisk);
+                }
+                if (base <= 0 || inst <= 0) {
+                    cerr << "hot_stats_overhead probes missing or failed next to this binary\n";
+                    return 1;
+                }
+                bestBase = min(bestBase, base);
+                best = min(best, inst);
+                ratios.push_back(inst / base);
+            }
+            sort(ratios.begin(), ratios.end());
+            size_t k = medianConfidenceRank(ratios.size());
+            double overhead = (ratios[ratios.size() / 2] - 1.0) * 100.0;
+            double low = (ratios[k - 1] - 1.0) * 100.0, high = (ratios[ratios.size() - k] - 1.0) * 100.0;
+            Bench::Reporter::Params p = {
+                {"tracker", withRisk ? "RealTimeTrackerWithRisk" : "RealTimeTracker"},
+                {"window", to_string(window)}, {"ticks", to_string(ticks)}};
+            rep.add("addPrice_uninstrumented", p, {1, bestBase}, (double)ticks);
+            rep.add("addPrice_instrumented", p, {1, best}, (double)ticks,
+                    {{"overhead_percent", overhead}, {"overhead_ci95_low_percent", low},
+                     {"overhead_ci95_high_percent", high}});
+            cerr << "    overhead " << overhead << "% (95% CI " << low << ".." << high << "%)"
+                 << (high < BUDGET_PERCENT ? "" : " -- not shown to be under the 1% budget") << "\n";
+        }
+    }
+
+    rep.write(opt);
+    return 0;
+}
@@ -0,0 +1,51 @@
+// hot_stats_overhead.cpp
+// One timing of the tracker hot path (addPrice over a random-walk stream),
+// built twice: hot_stats_overhead as shipped, hot_stats_overhead_nostats
+// with INVESTEDGE_NO_STATS. hot_stats_bench runs the pair alternately and
+// compares them. Prints the best of --reps passes, in seconds.
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "bench_common.hpp"
+#include "real_time_tracker.hpp"
+#include "risk_management.hpp"
+
+using namespace std;
+
+template <typename Tracker>
+static double pass(const vector<double>& ticks, size_t window) {
+    auto t0 = chrono::steady_clock::now();
+    Tracker tracker(window);
+    for (double p : ticks) tracker.addPrice(p);
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    uint64_t ticks = 1000000;
+    size_t window = 10;
+    bool withRisk = false;
+    int reps = 3;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        if (!strncmp(a, "--ticks=", 8)) ticks = stoull(a + 8);
+        else if (!strncmp(a, "--window=", 9)) window = stoul(a + 9);
+        else if (!strncmp(a, "--reps=", 7)) reps = stoi(a + 7);
+        else if (!strcmp(a, "--risk")) withRisk = true;
+        else {
+            fprintf(stderr, "Unknown option %s\n", a);
+            return 1;
+        }
+    }
+
+    vector<double> stream = Bench::makeTickStream(ticks);
+    double best = 1e30;
+    for (int r = 0; r <= reps; r++) {              // pass 0 warms caches and the allocator
+        double s = withRisk ? pass<RealTimeTrackerWithRisk::RealTimePriceTracker>(stream, window)
+                            : pass<RealTimeTracker::RealTimePriceTracker>(stream, window);
+        if (r > 0 && s < best) best = s;
+    }
+    printf("%.9f\n", best);
+    return 0;
+}
@@ -0,0 +1,109 @@
+// mark_to_market_bench.cpp
+// Per-tick cost of the mark-to-market engine at 1k and 50k positions (1M
+// random-walk ticks per pass): by position index, by ring record (symbol
+// lookup), and with a reader thread snapshotting continuously. Snapshot
+// cost and a full re-sum of the book are measured for comparison. Exits
+// non-zero if the totals drift from the re-sum, or if a ring carrying tick
+// and stats records per price is not counted once per price.
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "bench_common.hpp"
+#include "mark_to_market.hpp"
+
+using namespace std;
+namespace MTM = MarkToMarket;
+
+int main(int argc, char** argv) {
+    Bench::Options opt = Bench::parseOptions(argc, argv);
+    Bench::Reporter rep("mark_to_market");
+    const size_t TICKS = 1000000;
+
+    for (uint64_t n : opt.sizesOr({1000, 50000})) {
+        cerr << "marking " << n << " positions\n";
+        MTM::Book book = MTM::generateBook(n);
+        MTM::Engine e(book);
+
+        Bench::Rng rng(5);
+        vector<int> pos(TICKS);
+        vector<double> price(TICKS), last(n);
+        vector<TickRing::Record> records(TICKS);
+        for (size_t i = 0; i < n; i++) last[i] = book.holdings[i].price;
+        for (size_t k = 0; k < TICKS; k++) {
+            pos[k] = (int)rng.below(n);
+            last[pos[k]] *= 1.0 + 0.001 * rng.normal();
+            price[k] = last[pos[k]];
+            TickRing::Record& r = records[k];
+            r = TickRing::Record{};
+            r.kind = TickRing::KIND_TICK;
+            TickRing::setSymbol(r, book.holdings[pos[k]].symbol);
+            r.price = price[k];
+        }
+
+        Bench::Reporter::Params p = {{"positions", to_string(n)}, {"ticks", to_string(TICKS)}};
+        auto t = Bench::measure([&] {
+            for (size_t k = 0; k < TICKS; k++) e.apply(pos[k], price[k], (int64_t)k);
+        }, opt.minSeconds, 100);
+        rep.add("apply", p, t, (double)TICKS);
+
+        t = Bench::measure([&] {
+            for (size_t k = 0; k < TICKS; k++) e.apply(records[k]);
+        }, opt.minSeconds, 100);
+        rep.add("apply_record", p, t, (double)TICKS);
+
+        atomic<bool> stop{false};
+        atomic<uint64_t> snapshots{0};
+        thread reader([&] {
+            while (!stop.load(memory_order_relaxed)) {
+                Bench::doNotOptimize(e.snapshot().marketValue);
+                snapshots.fetch_add(1, memory_order_relaxed);
+            }
+        });
+        t = Bench::measure([&] {
+            for (size_t k = 0; k < TICKS; k++) e.apply(pos[k], price[k], (int64_t)k);
+        }, opt.minSeconds, 100);
+        stop = true;
+        reader.join();
+        rep.add("apply_with_reader", p, t, (double)TICKS,
+                {{"reader_snapshots", (double)snapshots.load()}});
+
+        t = Bench::measure([&] { Bench::doNotOptimize(e.snapshot().marketValue); }, opt.minSeconds);
+        rep.add("snapshot", p, t);
+
+        t = Bench::measure([&] { Bench::doNotOptimize(e.recompute().marketValue); }, opt.minSeconds);
+        rep.add("recompute", p, t);
+
+        if (e.recompute().marketValue != e.snapshot().marketValue) {
+            cerr << "incremental totals drifted from the re-sum\n";
+            return 1;
+        }
+
+        // A tracker publishes a tick and a stats record per price: following
+        // its ring must count each price once, not twice.
+        TickRing::Producer producer;
+        string ring = "/investedge_bench_mtm_" + to_string(getpid());
+        const size_t MIXED = 100000;
+        if (producer.open(ring, 2 * MIXED)) {
+            TickRing::Consumer consumer;
+            consumer.open(ring);
+            for (size_t k = 0; k < MIXED; k++) {
+                const string& sym = book.holdings[pos[k]].symbol;
+                producer.publishTick(sym, price[k]);
+                producer.publishStats(sym, price[k], price[k], price[k], price[k]);
+            }
+            MTM::Engine follower(book);
+            size_t records = consumer.poll([&](const TickRing::Record& r) { follower.apply(r); });
+            producer.unlink();
+            if (records != 2 * MIXED || follower.snapshot().ticks != MIXED) {
+                cerr << "mixed ring: " << follower.snapshot().ticks << " ticks applied from "
+                     << records << " records, expected " << MIXED << "\n";
+                return 1;
+            }
+        }
+    }
+
+    rep.write(opt);
+    return 0;
+}
@@ -0,0 +1,52 @@
+// portfolio_analyzer_bench.cpp
+// loadCSV / showTopMovers / showRankings / buildSectorGraph over synthetic
+// universes (default 1k, 100k, 1M stocks; --sizes=...,10000000 for 10M).
+#include <string>
+#include "bench_common.hpp"
+#include "portfolio_analyzer.hpp"
+
+using namespace std;
+namespace PA = PortfolioAnalyzer;
+
+static void resetUniverse() {
+    PA::stocks.clear();
+    PA::stockIndex.clear();
+    PA::sectorGraph.clear();
+}
+
+int main(int argc, char** argv) {
+    Bench::Options opt = Bench::parseOptions(argc, argv);
+    Bench::Reporter rep("portfolio_analyzer");
+    Bench::TempDir tmp;
+
+    for (uint64_t n : opt.sizesOr({1000, 100000, 1000000})) {
+        cerr << "universe of " << n << " stocks\n";
+        Bench::writeUniverseCSV("universe.csv", n);
+        Bench::Reporter::Params p = {{"stocks", to_string(n)}};
+
+        auto t = Bench::measure([] { PA::loadCSV("universe.csv"); },
+                                opt.minSeconds, 1000, resetUniverse);
+        rep.add("loadCSV", p, t, (double)n);
+
+        t = Bench::measure([] { PA::buildSectorGraph(); }, opt.minSeconds, 1000,
+                           [] { PA::sectorGraph.clear(); });
+        rep.add("buildSectorGraph", p, t, (double)n);
+
+        {
+            Bench::SilenceCout quiet;
+            t = Bench::measure([] { PA::showTopMovers(10); }, opt.minSeconds);
+        }
+        rep.add("showTopMovers", {{"stocks", to_string(n)}, {"k", "10"}}, t, (double)n);
+
+        {
+            Bench::SilenceCout quiet;
+            t = Bench::measure([] { PA::showRankings(); }, opt.minSeconds);
+        }
+        rep.add("showRankings", p, t, (double)n);
+
+        resetUniverse();
+    }
+
+    rep.write(opt);
+    return 0;
+}
@@ -0,0 +1,156 @@
+// price_stream_bench.cpp
+// WebSocket price ingestion against a local stub replaying a 100-symbol
+// tick file: unpaced throughput (frames coalesced as on a busy feed),
+// end-to-end latency at a fixed event rate (stub send stamp to tracker
+// update, p50/p99/max), and a run with dropped connections and sequence
+// gaps that exercises reconnect, resubscribe and REST backfill.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "bench_common.hpp"
+#include "stub_http_server.hpp"
+#include "stub_ws_server.hpp"
+
+using namespace std;
+namespace BT = Backtester;
+namespace PS = PriceStream;
+
+struct RunResult {
+    bool ok = false;
+    uint64_t prices = 0, restPrices = 0, reconnects = 0, gaps = 0, missed = 0;
+};
+
+// Streams the whole tick file from a fresh stub; ends once every sent price is in.
+static RunResult streamFile(const BT::TickFile& file, Bench::StubWsServer::Replay replay,
+                            PS::Options opt) {
+    RunResult r;
+    Bench::StubWsServer stub(file, replay);
+    if (!stub.start()) {
+        cerr << "stub WebSocket server unavailable\n";
+        return r;
+    }
+    opt.url = stub.url();
+    opt.symbols = file.symbols;
+    opt.verbose = false;
+    opt.ring = "/investedge_bench_stream_" + to_string(getpid());
+
+    Bench::SilenceCout quiet;
+    PS::Streamer streamer(opt);
+    auto t0 = chrono::steady_clock::now();
+    thread watcher([&] {
+        auto deadline = t0 + chrono::seconds(120);
+        while (!(stub.finished() && streamer.prices() >= stub.sent())) {
+            if (chrono::steady_clock::now() > deadline) {
+                cerr << "stream stalled at " << streamer.prices() << " of " << file.count << " prices\n";
+                break;
+            }
+            this_thread::sleep_for(chrono::microseconds(200));
+        }
+        streamer.stop();
+    });
+    streamer.run();
+    watcher.join();
+    shm_unlink(opt.ring.c_str());
+
+    r.prices = streamer.prices();
+    r.restPrices = streamer.restPrices();
+    r.reconnects = streamer.reconnects();
+    r.gaps = streamer.gaps();
+    r.missed = streamer.missed();
+    r.ok = stub.finished() && r.prices == stub.sent();
+    return r;
+}
+
+int main(int argc, char** argv) {
+    Bench::Options opt = Bench::parseOptions(argc, argv);
+    Bench::Reporter rep("price_stream");
+    Bench::TempDir tmp;
+    const uint32_t SYMBOLS = 100;
+
+    // Framing and event decoding alone, no socket.
+    {
+        string frames;
+        const int N = 1000;
+        for (int i = 0; i < N; i++)
+            PS::appendFrame(frames, PS::OP_TEXT,
+                "{\"event\":\"price\",\"symbol\":\"T00042\",\"currency\":\"USD\",\"exchange\":\"NASDAQ\","
+                "\"type\":\"Common Stock\",\"timestamp\":1592249566,\"price\":342.0100,\"seq\":"
+                + to_string(i) + ",\"ts_ns\":0}", false);
+        double sink = 0;
+        auto t = Bench::measure([&] {
+            const char* p = frames.data();
+            for (int i = 0; i < N; i++) {
+                size_t len = (unsigned char)p[1] & 0x7F;
+                PS::PriceEvent ev;
+                if (PS::parsePriceEvent(string_view(p + 2, len), ev)) sink += ev.price;
+                p += 2 + len;
+            }
+        }, opt.minSeconds);
+        rep.add("parsePriceEvent", {{"bytes", to_string(frames.size() / N)}}, t, N);
+        Bench::doNotOptimize(sink);
+    }
+
+    for (uint64_t n : opt.sizesOr({200000})) {
+        cerr << "streaming " << n << " ticks over " << SYMBOLS << " symbols\n";
+        if (!BT::generateTicks("ticks.bin", SYMBOLS, n)) return 1;
+        BT::TickFile file;
+        if (!file.open("ticks.bin")) return 1;
+        Bench::Reporter::Params p = {{"symbols", to_string(SYMBOLS)}, {"ticks", to_string(n)}};
+
+        PS::Options base;
+        base.restPrice = [](const string&, string*) { return 0.0; };   // no REST in the clean runs
+
+        RunResult r;
+        auto t = Bench::measure([&] { r = streamFile(file, Bench::StubWsServer::Replay(), base); }, opt.minSeconds, 5);
+        if (!r.ok) return 1;
+        rep.add("ingest", p, t, (double)n);
+
+        // Paced well below capacity so the numbers are queueing-free latency.
+        vector<int64_t> lat;
+        lat.reserve(n);
+        PS::Options paced = base;
+        paced.onPrice = [&lat](const PS::PriceEvent& ev, int64_t now) { lat.push_back(now - ev.sentNanos); };
+        uint64_t pacedTicks = min<uint64_t>(n, 50000);
+        BT::TickFile head;
+        head.open("ticks.bin");
+        head.count = pacedTicks;
+        Bench::StubWsServer::Replay rate;
+        rate.ticksPerSecond = 20000;
+        t = Bench::measure([&] { lat.clear(); r = streamFile(head, rate, paced); }, 0, 1);
+        if (!r.ok || lat.empty()) return 1;
+        sort(lat.begin(), lat.end());
+        auto pct = [&lat](double q) { return lat[(size_t)(q * (lat.size() - 1))] / 1e3; };
+        rep.add("latency_paced", {{"symbols", to_string(SYMBOLS)}, {"ticks", to_string(pacedTicks)},
+                                  {"rate", "20000/s"}}, t, (double)pacedTicks,
+                {{"p50_us", pct(0.5)}, {"p99_us", pct(0.99)}, {"max_us", lat.back() / 1e3}});
+
+        // Drops every 20k events and loses one in 5000; REST comes from a stub.
+        Bench::StubHttpServer rest;
+        rest.route("/price", Bench::pricePayload(194.25));
+        if (!rest.start()) {
+            cerr << "stub server unavailable, skipping reconnect run\n";
+            continue;
+        }
+        setenv("TWELVEDATA_BASE_URL", rest.baseUrl().c_str(), 1);
+        PS::Options faulty;
+        faulty.apiKey = "bench";
+        faulty.pollSeconds = 0.05;
+        Bench::StubWsServer::Replay faults;
+        faults.dropEvery = 20000;
+        faults.skipEvery = 5000;
+        t = Bench::measure([&] { r = streamFile(file, faults, faulty); }, 0, 1);
+        rest.stop();
+        if (!r.ok) return 1;
+        rep.add("ingest_with_faults", p, t, (double)r.prices,
+                {{"reconnects", (double)r.reconnects}, {"gaps", (double)r.gaps},
+                 {"missed", (double)r.missed}, {"rest_prices", (double)r.restPrices}});
+    }
+
+    rep.write(opt);
+    return 0;
+}
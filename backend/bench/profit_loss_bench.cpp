@@ -0,0 +1,46 @@
+// profit_loss_bench.cpp
+// LoadHistory / savehistory over synthetic trade histories
+// (default 1k, 100k, 1M rows; --sizes=...,10000000 for 10M).
+#include <string>
+#include "bench_common.hpp"
+#include "profit_loss.hpp"
+
+using namespace std;
+namespace PL = ProfitLossModule;
+
+static void resetLedger() {
+    PL::profitlosshistory = {};
+    PL::redoStack = {};
+    PL::totalInvestment = 0.0;
+    PL::totalProfitLoss = 0.0;
+}
+
+int main(int argc, char** argv) {
+    Bench::Options opt = Bench::parseOptions(argc, argv);
+    Bench::Reporter rep("profit_loss");
+    Bench::TempDir tmp;
+
+    for (uint64_t n : opt.sizesOr({1000, 100000, 1000000})) {
+        cerr << "trade history of " << n << " rows\n";
+        Bench::writeTradeHistoryCSV(PL::Fhistory, n);
+        Bench::Reporter::Params p = {{"rows", to_string(n)}};
+
+        auto t = Bench::measure([] { PL::LoadHistory(); }, opt.minSeconds, 1000, resetLedger);
+        rep.add("LoadHistory", p, t, (double)n);
+
+        // History stays loaded; savehistory rewrites the same file each time.
+        t = Bench::measure([] { PL::savehistory(); }, opt.minSeconds, 1000);
+        rep.add("savehistory", p, t, (double)n);
+
+        {
+            Bench::SilenceCout quiet;
+            t = Bench::measure([] { PL::DisplayHistory(); }, opt.minSeconds, 1000);
+        }
+        rep.add("DisplayHistory", p, t, (double)n);
+
+        resetLedger();
+    }
+
+    rep.write(opt);
+    return 0;
+}
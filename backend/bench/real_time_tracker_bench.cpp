@@ -0,0 +1,61 @@
+// real_time_tracker_bench.cpp
+// RealTimePriceTracker::addPrice for both trackers, price-response parsing
+// and the full getStockPrice round trip against a local stub server.
+#include <string>
+#include <cstdlib>
+#include "bench_common.hpp"
+#include "stub_http_server.hpp"
+#include "real_time_tracker.hpp"
+#include "risk_management.hpp"
+
+using namespace std;
+
+template <typename Tracker>
+static void benchAddPrice(Bench::Reporter& rep, const Bench::Options& opt,
+                          const string& name, const vector<double>& ticks) {
+    for (size_t window : {10, 100, 1000}) {
+        auto t = Bench::measure([&] {
+            Tracker tracker(window);
+            for (double p : ticks) tracker.addPrice(p);
+        }, opt.minSeconds, 1000);
+        rep.add(name, {{"window", to_string(window)}, {"ticks", to_string(ticks.size())}},
+                t, (double)ticks.size());
+    }
+}
+
+int main(int argc, char** argv) {
+    Bench::Options opt = Bench::parseOptions(argc, argv);
+    Bench::Reporter rep("real_time_tracker");
+
+    uint64_t ticks = opt.sizesOr({1000000})[0];
+    vector<double> stream = Bench::makeTickStream(ticks);
+
+    benchAddPrice<RealTimeTracker::RealTimePriceTracker>(
+        rep, opt, "RealTimeTracker::addPrice", stream);
+    benchAddPrice<RealTimeTrackerWithRisk::RealTimePriceTracker>(
+        rep, opt, "RealTimeTrackerWithRisk::addPrice", stream);
+
+    string body = Bench::pricePayload(194.25);
+    double sink = 0;
+    auto t = Bench::measure([&] {
+        for (int i = 0; i < 1000; i++) sink += RealTimeTracker::parsePriceResponse(body);
+    }, opt.minSeconds);
+    rep.add("parsePriceResponse", {{"bytes", to_string(body.size())}}, t, 1000);
+
+    Bench::StubHttpServer stub;
+    stub.route("/price", body);
+    if (stub.start()) {
+        setenv("TWELVEDATA_BASE_URL", stub.baseUrl().c_str(), 1);
+        t = Bench::measure([&] {
+            for (int i = 0; i < 50; i++) sink += RealTimeTracker::getStockPrice("AAPL", "bench");
+        }, opt.minSeconds, 200);
+        rep.add("getStockPrice", {{"server", "local_stub"}}, t, 50);
+        stub.stop();
+    } else {
+        cerr << "stub server unavailable, skipping getStockPrice\n";
+    }
+
+    Bench::doNotOptimize(sink);
+    rep.write(opt);
+    return 0;
+}
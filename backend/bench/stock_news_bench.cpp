@@ -0,0 +1,44 @@
+// stock_news_bench.cpp
+// NewsAPI response parsing/printing and the full FetchStockNews round trip
+// against a local stub server.
+#include <string>
+#include <cstdlib>
+#include "bench_common.hpp"
+#include "stub_http_server.hpp"
+#include "stock_news.hpp"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    Bench::Options opt = Bench::parseOptions(argc, argv);
+    Bench::Reporter rep("stock_news");
+
+    for (uint64_t articles : opt.sizesOr({15, 100, 1000})) {
+        string body = Bench::newsPayload((int)articles);
+        Bench::Timing t;
+        {
+            Bench::SilenceCout quiet;
+            t = Bench::measure([&] { StockNews::PrintStockNews(body); }, opt.minSeconds);
+        }
+        rep.add("PrintStockNews", {{"articles", to_string(articles)},
+                                   {"bytes", to_string(body.size())}}, t, 1);
+    }
+
+    Bench::StubHttpServer stub;
+    stub.route("/v2/everything", Bench::newsPayload(15));
+    if (stub.start()) {
+        setenv("NEWSAPI_BASE_URL", stub.baseUrl().c_str(), 1);
+        Bench::Timing t;
+        {
+            Bench::SilenceCout quiet;
+            t = Bench::measure([] { StockNews::FetchStockNews(); }, opt.minSeconds, 500);
+        }
+        rep.add("FetchStockNews", {{"server", "local_stub"}, {"articles", "15"}}, t, 1);
+        stub.stop();
+    } else {
+        cerr << "stub server unavailable, skipping FetchStockNews\n";
+    }
+
+    rep.write(opt);
+    return 0;
+}
@@ -0,0 +1,115 @@
+// stock_screener_bench.cpp
+// Screening over synthetic universes (default 100k and 1M stocks): column
+// table build, compile + bitmap evaluation on 1 thread and all cores, the
+// full screen with sort/limit, and a row-at-a-time loop over the Stock
+// structs with the same predicate as a baseline. Every universe, plus one
+// whose size is not a multiple of 64, is first checked for the bitmap and
+// the row loop agreeing on the match count.
+#include <string>
+#include <thread>
+#include "bench_common.hpp"
+#include "portfolio_analyzer.hpp"
+#include "stock_screener.hpp"
+
+using namespace std;
+namespace PA = PortfolioAnalyzer;
+namespace SS = StockScreener;
+
+struct Case {
+    string expr;
+    bool (*row)(const PA::Stock&);       // the same predicate, row at a time
+};
+
+static const Case CASES[] = {
+    {"sector == \"IT\" && changePercent > 1.5 && marketCap > 1e6",
+     [](const PA::Stock& s) { return s.sector == "IT" && s.changePercent > 1.5 && s.marketCap > 1e6; }},
+    {"changePercent > 0 || (price < 50 && sector != \"Banking\")",
+     [](const PA::Stock& s) { return s.changePercent > 0 || (s.price < 50 && s.sector != "Banking"); }},
+};
+
+static bool loadUniverse(uint64_t n) {
+    Bench::writeUniverseCSV("universe.csv", n);
+    PA::stocks.clear();
+    PA::stockIndex.clear();
+    return PA::loadCSV("universe.csv");
+}
+
+// countMatches(select()) must equal the row loop's hit count on 1 thread and all cores.
+static bool agrees(const SS::Table& table, const Case& c, unsigned cores) {
+    SS::Screen s;
+    if (!s.compile(c.expr, table)) return false;
+    size_t hits = 0;
+    for (const PA::Stock& st : PA::stocks) hits += c.row(st);
+    for (unsigned threads : {1u, cores}) {
+        size_t got = SS::countMatches(s.select(threads));
+        if (got != hits) {
+            cerr << "MISMATCH: " << c.expr << " on " << table.rows << " rows, " << threads
+                 << " threads: bitmap " << got << " vs row loop " << hits << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Bench::Options opt = Bench::parseOptions(argc, argv);
+    Bench::Reporter rep("stock_screener");
+    Bench::TempDir tmp;
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    const string& narrow = CASES[0].expr;
+
+    // A ragged last word (and last chunk) on top of whatever sizes are benched.
+    if (!loadUniverse(40000 + 37)) return 1;
+    for (const Case& c : CASES)
+        if (!agrees(SS::buildTable(PA::stocks), c, cores)) return 1;
+
+    for (uint64_t n : opt.sizesOr({100000, 1000000})) {
+        cerr << "universe of " << n << " stocks\n";
+        if (!loadUniverse(n)) return 1;
+        Bench::Reporter::Params p = {{"stocks", to_string(n)}};
+
+        SS::Table table;
+        auto t = Bench::measure([&] { table = SS::buildTable(PA::stocks); }, opt.minSeconds, 100);
+        rep.add("buildTable", p, t, (double)n);
+
+        for (const Case& c : CASES) {
+            if (!agrees(table, c, cores)) return 1;
+            const string* expr = &c.expr;
+            SS::Screen s;
+            if (!s.compile(*expr, table)) return 1;
+            double matches = (double)SS::countMatches(s.select());
+            for (unsigned threads : {1u, cores}) {
+                Bench::Reporter::Params sp = p;
+                sp.push_back({"expr", *expr});
+                sp.push_back({"threads", to_string(threads)});
+                t = Bench::measure([&] { Bench::doNotOptimize(s.select(threads).size()); }, opt.minSeconds);
+                rep.add("select", sp, t, (double)n, {{"matches", matches}});
+            }
+
+            SS::Order order;
+            SS::parseOrder("-changePercent", order);
+            order.limit = 50;
+            Bench::Reporter::Params sp = p;
+            sp.push_back({"expr", *expr});
+            sp.push_back({"sort", "-changePercent"});
+            sp.push_back({"limit", "50"});
+            vector<uint32_t> rows;
+            size_t found = 0;
+            t = Bench::measure([&] { SS::screen(table, *expr, order, rows, found); }, opt.minSeconds);
+            rep.add("screen", sp, t, (double)n, {{"matches", (double)found}});
+        }
+
+        Bench::Reporter::Params bp = p;
+        bp.push_back({"expr", narrow});
+        t = Bench::measure([&] {
+            size_t hits = 0;
+            for (const PA::Stock& s : PA::stocks)             // inline, not through CASES[0].row
+                hits += s.sector == "IT" && s.changePercent > 1.5 && s.marketCap > 1e6;
+            Bench::doNotOptimize(hits);
+        }, opt.minSeconds);
+        rep.add("row_loop_baseline", bp, t, (double)n);
+    }
+
+    rep.write(opt);
+    return 0;
+}
@@ -0,0 +1,122 @@
+// stub_http_server.hpp
+// Minimal local HTTP/1.1 server for benchmarking the curl paths without
+// touching the real APIs. Serves canned bodies by path prefix on 127.0.0.1.
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Bench {
+
+class StubHttpServer {
+private:
+    std::vector<std::pair<std::string, std::string>> routes;  // prefix → body
+    int listenFd = -1;
+    int boundPort = 0;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> served{0};
+    std::thread worker;
+
+    const std::string* bodyFor(const std::string& path) const {
+        for (auto& r : routes)
+            if (path.compare(0, r.first.size(), r.first) == 0) return &r.second;
+        return nullptr;
+    }
+
+    void handle(int fd) {
+        std::string req;
+        char buf[4096];
+        while (req.find("\r\n\r\n") == std::string::npos) {
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) return;
+            req.append(buf, (size_t)n);
+        }
+        // "GET /path HTTP/1.1"
+        size_t sp1 = req.find(' '), sp2 = req.find(' ', sp1 + 1);
+        std::string path = sp1 == std::string::npos ? "/" : req.substr(sp1 + 1, sp2 - sp1 - 1);
+
+        const std::string* body = bodyFor(path);
+        std::string resp;
+        if (body) {
+            resp = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                   std::to_string(body->size()) + "\r\nConnection: close\r\n\r\n" + *body;
+        } else {
+            resp = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        }
+        size_t off = 0;
+        while (off < resp.size()) {
+            ssize_t n = send(fd, resp.data() + off, resp.size() - off, MSG_NOSIGNAL);
+            if (n <= 0) return;
+            off += (size_t)n;
+        }
+        served++;
+    }
+
+public:
+    StubHttpServer() = default;
+    StubHttpServer(const StubHttpServer&) = delete;
+    StubHttpServer& operator=(const StubHttpServer&) = delete;
+    ~StubHttpServer() { stop(); }
+
+    void route(const std::string& prefix, std::string body) {
+        routes.emplace_back(prefix, std::move(body));
+    }
+
+    // Binds an ephemeral port and starts serving; returns false on failure.
+    bool start() {
+        listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listenFd < 0) return false;
+        int one = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd, 128) != 0) {
+            close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+        socklen_t len = sizeof(addr);
+        getsockname(listenFd, (sockaddr*)&addr, &len);
+        boundPort = ntohs(addr.sin_port);
+
+        worker = std::thread([this] {
+            while (!stopping.load()) {
+                int fd = accept(listenFd, nullptr, nullptr);
+                if (fd < 0) continue;
+                int nodelay = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+                handle(fd);
+                close(fd);
+            }
+        });
+        return true;
+    }
+
+    void stop() {
+        if (listenFd < 0) return;
+        stopping.store(true);
+        shutdown(listenFd, SHUT_RDWR);
+        close(listenFd);
+        listenFd = -1;
+        if (worker.joinable()) worker.join();
+    }
+
+    int port() const { return boundPort; }
+    std::string baseUrl() const { return "http://127.0.0.1:" + std::to_string(boundPort); }
+    uint64_t requestsServed() const { return served.load(); }
+};
+
+} // namespace Bench
@@ -0,0 +1,197 @@
+// stub_ws_server.hpp
+// Minimal local WebSocket server for benchmarking the price stream without
+// touching the real feed. Replays a backtester tick file as Twelve Data
+// price events on 127.0.0.1, one connection at a time, resuming where the
+// last connection stopped. Each event carries a feed sequence number and
+// the steady-clock send time so the client can measure end-to-end latency.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "backtester.hpp"
+#include "hot_stats.hpp"
+#include "price_stream.hpp"
+
+namespace Bench {
+
+class StubWsServer {
+public:
+    struct Replay {
+        double ticksPerSecond = 0;   // 0 = as fast as the socket takes them
+        uint64_t dropEvery = 0;      // close the connection after this many ticks
+        uint64_t skipEvery = 0;      // drop every Nth tick, leaving a sequence gap
+    };
+
+private:
+    const Backtester::TickFile& file;
+    Replay replay;
+    int listenFd = -1;
+    int boundPort = 0;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> sentTicks{0}, skipped{0}, connections{0};
+    uint64_t next = 0, seq = 0;     // replay position, touched by the worker only
+    std::thread worker;
+
+    static bool sendAll(int fd, const char* p, size_t n) {
+        while (n > 0) {
+            ssize_t w = send(fd, p, n, MSG_NOSIGNAL);
+            if (w <= 0) return false;
+            p += w;
+            n -= (size_t)w;
+        }
+        return true;
+    }
+
+    // Reads one client frame (clients always mask); false on EOF or error.
+    static bool readFrame(int fd, std::string& pending, std::string& payload) {
+        for (;;) {
+            if (pending.size() >= 6) {
+                const unsigned char* p = (const unsigned char*)pending.data();
+                size_t len = p[1] & 0x7F, hdr = 2;
+                if (len == 126) { len = (size_t)p[2] << 8 | p[3]; hdr = 4; }
+                else if (len == 127) return false;   // subscribe/heartbeat frames are small
+                if (pending.size() >= hdr + 4 + len) {
+                    payload.assign(pending, hdr + 4, len);
+                    for (size_t i = 0; i < len; i++) payload[i] ^= pending[hdr + (i & 3)];
+                    pending.erase(0, hdr + 4 + len);
+                    return true;
+                }
+            }
+            char buf[4096];
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) return false;
+            pending.append(buf, (size_t)n);
+        }
+    }
+
+    bool handshake(int fd, std::string& pending) {
+        std::string req;
+        char buf[4096];
+        size_t end;
+        while ((end = req.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) return false;
+            req.append(buf, (size_t)n);
+        }
+        pending = req.substr(end + 4);
+        size_t k = req.find("Sec-WebSocket-Key:");
+        if (k == std::string::npos) return false;
+        k = req.find_first_not_of(' ', k + 18);
+        std::string key = req.substr(k, req.find("\r\n", k) - k);
+        std::string resp = "HTTP/1.1 101 Switching Protocols\r\n"
+                           "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+                           "Sec-WebSocket-Accept: " + PriceStream::websocketAccept(key) + "\r\n\r\n";
+        return sendAll(fd, resp.data(), resp.size());
+    }
+
+    void serve(int fd) {
+        std::string pending, payload;
+        if (!handshake(fd, pending) || !readFrame(fd, pending, payload)) return;   // subscribe
+        connections++;
+
+        // Paced replays send each event on its own; unpaced ones coalesce
+        // frames into ~64 KB writes like a busy feed would.
+        const size_t flushAt = replay.ticksPerSecond > 0 ? 1 : 64 * 1024;
+        auto start = std::chrono::steady_clock::now();
+        uint64_t onThisConnection = 0;
+        std::string out;
+        char msg[256];
+        while (next < file.count && !stopping.load()) {
+            if (replay.ticksPerSecond > 0)
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(onThisConnection / replay.ticksPerSecond)));
+            const Backtester::Tick& t = file.ticks[next++];
+            if (replay.skipEvery && next % replay.skipEvery == 0) {
+                seq++;                          // lost upstream: the client sees a gap
+                skipped++;
+                continue;
+            }
+            int n = std::snprintf(msg, sizeof(msg),
+                "{\"event\":\"price\",\"symbol\":\"%s\",\"currency\":\"USD\",\"exchange\":\"NASDAQ\","
+                "\"type\":\"Common Stock\",\"timestamp\":%lld,\"price\":%.4f,\"seq\":%llu,\"ts_ns\":%lld}",
+                file.symbols[t.symbol].c_str(), (long long)(t.tsNanos / 1000000000), t.price,
+                (unsigned long long)++seq, (long long)HotStats::nowNanos());
+            PriceStream::appendFrame(out, PriceStream::OP_TEXT, std::string_view(msg, (size_t)n), false);
+            onThisConnection++;
+            sentTicks++;
+            bool drop = replay.dropEvery && onThisConnection == replay.dropEvery;
+            if (out.size() >= flushAt || next >= file.count || drop) {
+                if (!sendAll(fd, out.data(), out.size())) return;
+                out.clear();
+            }
+            if (drop) return;
+        }
+        if (!out.empty() && !sendAll(fd, out.data(), out.size())) return;
+
+        // Replay finished: stay connected (ignoring heartbeats) until the client leaves.
+        while (!stopping.load()) {
+            pollfd p{fd, POLLIN, 0};
+            if (::poll(&p, 1, 50) > 0 && !readFrame(fd, pending, payload)) return;
+        }
+    }
+
+public:
+    StubWsServer(const Backtester::TickFile& ticks, Replay r) : file(ticks), replay(r) {}
+    StubWsServer(const StubWsServer&) = delete;
+    StubWsServer& operator=(const StubWsServer&) = delete;
+    ~StubWsServer() { stop(); }
+
+    // Binds an ephemeral port and starts serving; returns false on failure.
+    bool start() {
+        listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listenFd < 0) return false;
+        int one = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd, 16) != 0) {
+            close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+        socklen_t len = sizeof(addr);
+        getsockname(listenFd, (sockaddr*)&addr, &len);
+        boundPort = ntohs(addr.sin_port);
+
+        worker = std::thread([this] {
+            while (!stopping.load()) {
+                int fd = accept(listenFd, nullptr, nullptr);
+                if (fd < 0) continue;
+                int nodelay = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+                serve(fd);
+                close(fd);
+            }
+        });
+        return true;
+    }
+
+    void stop() {
+        if (listenFd < 0) return;
+        stopping.store(true);
+        shutdown(listenFd, SHUT_RDWR);
+        close(listenFd);
+        listenFd = -1;
+        if (worker.joinable()) worker.join();
+    }
+
+    std::string url() const { return "ws://127.0.0.1:" + std::to_string(boundPort) + "/v1/quotes/price"; }
+    uint64_t sent() const { return sentTicks.load(); }
+    uint64_t accepted() const { return connections.load(); }
+    uint64_t gapped() const { return skipped.load(); }
+    bool finished() const { return sentTicks.load() + skipped.load() == file.count; }
+};
+
+} // namespace Bench
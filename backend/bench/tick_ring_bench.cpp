@@ -0,0 +1,128 @@
+// tick_ring_bench.cpp
+// Throughput and end-to-end latency of the shared-memory tick ring with
+// 1, 8 and 64 subscribers.
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <unistd.h>
+#include "bench_common.hpp"
+#include "hot_stats.hpp"
+#include "tick_ring.hpp"
+
+using namespace std;
+
+namespace TickRingBench {
+
+struct Result {
+    int subscribers;
+    double publishRate;      // records/s written by the producer
+    double deliverRate;      // records/s summed over all subscribers
+    uint64_t received, lost;
+    HotStats::HistogramSnapshot latency;
+};
+
+/*===========================
+   One Run
+===========================*/
+// pacedGapNs == 0 publishes back-to-back (throughput); otherwise the producer
+// sleeps between records so latency reflects delivery, not queueing.
+// Subscribers record into a HotStats histogram, one per run, merged from
+// their shards once they exit.
+Result runOnce(const string& mode, int subscribers, uint64_t records, uint64_t pacedGapNs) {
+    string labels = "mode=\"" + mode + "\",subscribers=\"" + to_string(subscribers) + "\"";
+    HotStats::Histogram latency = HotStats::histogram(
+        "investedge_tick_ring_latency_seconds", labels,
+        "Delay from publishing a tick to a subscriber reading it.");
+    string name = "/investedge_bench_" + to_string(getpid());
+    TickRing::Producer producer;
+    if (!producer.open(name, 1 << 16)) {
+        cerr << "Could not create shared memory segment " << name << "\n";
+        exit(1);
+    }
+
+    atomic<bool> done{false};
+    atomic<int> ready{0};
+    vector<uint64_t> received(subscribers, 0), lost(subscribers, 0);
+    vector<thread> threads;
+
+    for (int i = 0; i < subscribers; i++) {
+        threads.emplace_back([&, i] {
+            TickRing::Consumer c;
+            if (!c.open(name, true)) { cerr << "attach failed\n"; exit(1); }
+            ready++;
+            uint64_t n = 0;
+            while (true) {
+                size_t got = c.poll([&](const TickRing::Record& r) {
+                    latency.recordSince(r.tsNanos);
+                    n++;
+                });
+                if (got == 0) {
+                    if (done.load(memory_order_acquire) && c.backlog() == 0) break;
+                    this_thread::yield();
+                }
+            }
+            received[i] = n;
+            lost[i] = c.lost();
+        });
+    }
+    while (ready.load() < subscribers) this_thread::yield();
+
+    auto t0 = chrono::steady_clock::now();
+    for (uint64_t k = 0; k < records; k++) {
+        producer.publishTick("AAPL", 100.0 + (double)(k % 100));
+        if (pacedGapNs) this_thread::sleep_for(chrono::nanoseconds(pacedGapNs));
+    }
+    auto t1 = chrono::steady_clock::now();
+    done.store(true, memory_order_release);
+    for (auto& t : threads) t.join();
+    auto t2 = chrono::steady_clock::now();
+
+    producer.unlink();
+
+    Result r{};
+    r.subscribers = subscribers;
+    r.publishRate = records / chrono::duration<double>(t1 - t0).count();
+    for (int i = 0; i < subscribers; i++) {
+        r.received += received[i];
+        r.lost += lost[i];
+    }
+    for (const HotStats::HistogramSnapshot& h : HotStats::collect().histograms)
+        if (h.labels == labels) r.latency = h;
+    r.deliverRate = r.received / chrono::duration<double>(t2 - t0).count();
+    return r;
+}
+
+void report(Bench::Reporter& rep, const string& mode, uint64_t records, const Result& r) {
+    Bench::Timing t{1, records / r.publishRate};
+    rep.add("TickRing::" + mode, {{"subscribers", to_string(r.subscribers)},
+                                  {"records", to_string(records)}},
+            t, (double)records,
+            {{"deliver_per_sec", r.deliverRate},
+             {"received", (double)r.received},
+             {"lost", (double)r.lost},
+             {"latency_p50_ns", (double)r.latency.percentile(50)},
+             {"latency_p99_ns", (double)r.latency.percentile(99)},
+             {"latency_max_ns", (double)r.latency.max}});
+}
+
+void run(const Bench::Options& opt) {
+    Bench::Reporter rep("tick_ring");
+    uint64_t records = opt.sizesOr({5000000})[0];
+    uint64_t paced = 20000;
+
+    // ops_per_sec is the producer's publish rate; deliver_per_sec sums all subscribers.
+    for (int subs : {1, 8, 64}) report(rep, "throughput", records, runOnce("throughput", subs, records, 0));
+    for (int subs : {1, 8, 64}) report(rep, "paced", paced, runOnce("paced", subs, paced, 20000));
+    rep.write(opt);
+}
+
+} // namespace TickRingBench
+
+int main(int argc, char** argv) {
+    TickRingBench::run(Bench::parseOptions(argc, argv));
+    return 0;
+}
@@ -0,0 +1,331 @@
+// hot_stats.cpp
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include "hot_stats.hpp"
+
+using namespace std;
+
+namespace HotStats {
+
+/*===========================
+   Shard Storage
+===========================*/
+HistogramShard::HistogramShard() : count(0), sum(0), max(0) {
+    for (auto& b : buckets) b.store(0, memory_order_relaxed);
+}
+
+Shard::Shard() {
+    for (auto& c : counters) c.store(0, memory_order_relaxed);
+    for (auto& h : histograms) h.store(nullptr, memory_order_relaxed);
+}
+
+namespace {
+
+struct MetricInfo {
+    string name, labels, help;
+};
+
+// Everything behind one mutex; only registration, thread attach/exit and
+// reads take it, never the hot path.
+struct Registry {
+    mutex mtx;
+    vector<MetricInfo> counters, histograms;
+    vector<Shard*> live;
+    vector<LocalCounter*> locals;
+    Shard retired;                      // totals of threads/objects that are gone
+    int64_t startNs = nowNanos();
+};
+
+Registry& registry() {
+    static Registry* r = new Registry();   // never destroyed: threads may outlive statics
+    return *r;
+}
+
+void addInto(HistogramShard& dst, const HistogramShard& src) {
+    for (int i = 0; i < BUCKETS; i++)
+        HistogramShard::bump(dst.buckets[i], src.buckets[i].load(memory_order_relaxed));
+    HistogramShard::bump(dst.count, src.count.load(memory_order_relaxed));
+    HistogramShard::bump(dst.sum, src.sum.load(memory_order_relaxed));
+    uint64_t m = src.max.load(memory_order_relaxed);
+    if (m > dst.max.load(memory_order_relaxed)) dst.max.store(m, memory_order_relaxed);
+}
+
+// Folds a finished thread's shard into Registry::retired so nothing is lost.
+struct ThreadExit {
+    Shard* shard = nullptr;
+    ~ThreadExit() {
+        if (!shard) return;
+        Registry& r = registry();
+        lock_guard<mutex> lock(r.mtx);
+        for (int i = 0; i < MAX_COUNTERS; i++)
+            HistogramShard::bump(r.retired.counters[i], shard->counters[i].load(memory_order_relaxed));
+        for (int i = 0; i < MAX_HISTOGRAMS; i++) {
+            HistogramShard* h = shard->histograms[i].load(memory_order_relaxed);
+            if (!h) continue;
+            HistogramShard* dst = r.retired.histograms[i].load(memory_order_relaxed);
+            addInto(dst ? *dst : allocateHistogram(r.retired, i), *h);
+            delete h;
+        }
+        for (size_t i = 0; i < r.live.size(); i++)
+            if (r.live[i] == shard) { r.live.erase(r.live.begin() + i); break; }
+        delete shard;
+        tlsShard = nullptr;
+    }
+};
+thread_local ThreadExit threadExit;
+
+int registerMetric(vector<MetricInfo>& list, int capacity, const string& name,
+                   const string& labels, const string& help) {
+    Registry& r = registry();
+    lock_guard<mutex> lock(r.mtx);
+    for (size_t i = 0; i < list.size(); i++)
+        if (list[i].name == name && list[i].labels == labels) return (int)i;
+    // The last slot is a shared overflow sink that is never reported.
+    if ((int)list.size() >= capacity - 1) {
+        cerr << "HotStats: too many metrics, dropping " << name << "\n";
+        return capacity - 1;
+    }
+    list.push_back({name, labels, help});
+    return (int)list.size() - 1;
+}
+
+} // namespace
+
+Shard* attachThread() {
+    Shard* s = new Shard();
+    {
+        Registry& r = registry();
+        lock_guard<mutex> lock(r.mtx);
+        r.live.push_back(s);
+    }
+    threadExit.shard = s;
+    tlsShard = s;
+    return s;
+}
+
+LocalCounter::LocalCounter(Counter family) : id(family.id) {
+    Registry& r = registry();
+    lock_guard<mutex> lock(r.mtx);
+    slot = r.locals.size();
+    r.locals.push_back(this);
+}
+
+LocalCounter::~LocalCounter() {
+    Registry& r = registry();
+    lock_guard<mutex> lock(r.mtx);
+    HistogramShard::bump(r.retired.counters[id], get());
+    // Swap-remove: order does not matter, and trackers come and go by the thousand.
+    r.locals[slot] = r.locals.back();
+    r.locals[slot]->slot = slot;
+    r.locals.pop_back();
+}
+
+HistogramShard& allocateHistogram(Shard& s, int id) {
+    HistogramShard* h = new HistogramShard();
+    s.histograms[id].store(h, memory_order_release);
+    return *h;
+}
+
+Counter counter(const string& name, const string& labels, const string& help) {
+    Counter c;
+    c.id = registerMetric(registry().counters, MAX_COUNTERS, name, labels, help);
+    return c;
+}
+
+Histogram histogram(const string& name, const string& labels, const string& help) {
+    Histogram h;
+    h.id = registerMetric(registry().histograms, MAX_HISTOGRAMS, name, labels, help);
+    return h;
+}
+
+/*===========================
+   Reading
+===========================*/
+uint64_t HistogramSnapshot::percentile(double p) const {
+    if (count == 0) return 0;
+    uint64_t target = (uint64_t)(p / 100.0 * (double)(count - 1));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen > target) return std::min(bucketUpperBound((int)i) - 1, max);
+    }
+    return max;
+}
+
+Snapshot collect() {
+    Registry& r = registry();
+    lock_guard<mutex> lock(r.mtx);
+    Snapshot snap;
+    snap.uptimeSeconds = (nowNanos() - r.startNs) / 1e9;
+
+    vector<Shard*> shards(r.live);
+    shards.push_back(&r.retired);
+
+    for (size_t i = 0; i < r.counters.size(); i++) {
+        CounterSnapshot c{r.counters[i].name, r.counters[i].labels, r.counters[i].help, 0};
+        for (Shard* s : shards) c.value += s->counters[i].load(memory_order_relaxed);
+        for (const LocalCounter* l : r.locals)
+            if (l->family() == (int)i) c.value += l->get();
+        snap.counters.push_back(c);
+    }
+    for (size_t i = 0; i < r.histograms.size(); i++) {
+        HistogramSnapshot h;
+        h.name = r.histograms[i].name;
+        h.labels = r.histograms[i].labels;
+        h.help = r.histograms[i].help;
+        h.buckets.assign(BUCKETS, 0);
+        for (Shard* s : shards) {
+            const HistogramShard* hs = s->histograms[i].load(memory_order_acquire);
+            if (!hs) continue;
+            for (int b = 0; b < BUCKETS; b++) h.buckets[b] += hs->buckets[b].load(memory_order_relaxed);
+            h.count += hs->count.load(memory_order_relaxed);
+            h.sum += hs->sum.load(memory_order_relaxed);
+            h.max = std::max(h.max, hs->max.load(memory_order_relaxed));
+        }
+        snap.histograms.push_back(h);
+    }
+    return snap;
+}
+
+/*===========================
+   Prometheus Text Format
+===========================*/
+namespace {
+
+const double LE_BOUNDS[] = {1e-6, 5e-6, 1e-5, 5e-5, 1e-4, 5e-4, 1e-3, 5e-3,
+                            1e-2, 5e-2, 0.1, 0.5, 1, 5, 10, 30};
+
+string withLabels(const string& labels, const string& extra = "") {
+    if (labels.empty() && extra.empty()) return "";
+    if (labels.empty()) return "{" + extra + "}";
+    if (extra.empty()) return "{" + labels + "}";
+    return "{" + labels + "," + extra + "}";
+}
+
+string fmt(double v) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.9g", v);
+    return buf;
+}
+
+// Series of one family must be contiguous under a single HELP/TYPE block, but
+// families get labels registered whenever their call sites first run. Stable
+// regroup by name, families in order of first appearance.
+template <typename T>
+vector<const T*> byFamily(const vector<T>& series) {
+    vector<string> order;
+    for (const T& s : series)
+        if (find(order.begin(), order.end(), s.name) == order.end()) order.push_back(s.name);
+    vector<const T*> out;
+    for (const string& name : order)
+        for (const T& s : series)
+            if (s.name == name) out.push_back(&s);
+    return out;
+}
+
+} // namespace
+
+void writePrometheus(ostream& out) {
+    Snapshot snap = collect();
+    string lastFamily;
+
+    out << "# HELP investedge_uptime_seconds Seconds since instrumentation started.\n"
+        << "# TYPE investedge_uptime_seconds gauge\n"
+        << "investedge_uptime_seconds " << fmt(snap.uptimeSeconds) << "\n";
+
+    for (const CounterSnapshot* cp : byFamily(snap.counters)) {
+        const CounterSnapshot& c = *cp;
+        if (c.name != lastFamily) {
+            out << "# HELP " << c.name << " " << c.help << "\n"
+                << "# TYPE " << c.name << " counter\n";
+            lastFamily = c.name;
+        }
+        out << c.name << withLabels(c.labels) << " " << c.value << "\n";
+    }
+
+    for (const HistogramSnapshot* hp : byFamily(snap.histograms)) {
+        const HistogramSnapshot& h = *hp;
+        if (h.name != lastFamily) {
+            out << "# HELP " << h.name << " " << h.help << "\n"
+                << "# TYPE " << h.name << " histogram\n";
+            lastFamily = h.name;
+        }
+        // A fine bucket counts towards `le` only if it lies entirely below it,
+        // so cumulative counts err on the side of slower.
+        for (double le : LE_BOUNDS) {
+            uint64_t leNs = (uint64_t)(le * 1e9), cum = 0;
+            for (int b = 0; b < BUCKETS && bucketUpperBound(b) <= leNs + 1; b++) cum += h.buckets[b];
+            out << h.name << "_bucket" << withLabels(h.labels, "le=\"" + fmt(le) + "\"") << " " << cum << "\n";
+        }
+        out << h.name << "_bucket" << withLabels(h.labels, "le=\"+Inf\"") << " " << h.count << "\n"
+            << h.name << "_sum" << withLabels(h.labels) << " " << fmt(h.sum / 1e9) << "\n"
+            << h.name << "_count" << withLabels(h.labels) << " " << h.count << "\n";
+    }
+}
+
+void printStats(ostream& out) {
+    Snapshot snap = collect();
+    ios::fmtflags flags = out.flags();
+    streamsize prec = out.precision();
+    out << fixed << setprecision(2);
+
+    out << "\n===== HOT PATH STATS (uptime " << snap.uptimeSeconds << " s) =====\n";
+    for (auto& c : snap.counters) {
+        double rate = snap.uptimeSeconds > 0 ? c.value / snap.uptimeSeconds : 0;
+        out << c.name << withLabels(c.labels) << " : " << c.value
+            << " (" << rate << "/s)\n";
+    }
+    for (auto& h : snap.histograms) {
+        out << h.name << withLabels(h.labels) << " : n=" << h.count;
+        if (h.count) {
+            out << " avg=" << h.sum / 1e3 / h.count << "us"
+                << " p50=" << h.percentile(50) / 1e3 << "us"
+                << " p90=" << h.percentile(90) / 1e3 << "us"
+                << " p99=" << h.percentile(99) / 1e3 << "us"
+                << " max=" << h.max / 1e3 << "us";
+        }
+        out << "\n";
+    }
+    out.flags(flags);
+    out.precision(prec);
+}
+
+/*===========================
+   Periodic Dump
+===========================*/
+void startPeriodicDump(const string& path, double intervalSeconds) {
+    static once_flag started;
+    call_once(started, [path, intervalSeconds] {
+        auto interval = chrono::duration<double>(intervalSeconds > 0 ? intervalSeconds : 10.0);
+        thread([path, interval] {
+            string tmp = path + ".tmp";
+            while (true) {
+                this_thread::sleep_for(interval);
+                {
+                    ofstream f(tmp);
+                    writePrometheus(f);
+                    if (!f) continue;
+                }
+                if (rename(tmp.c_str(), path.c_str()) != 0)
+                    cerr << "HotStats: could not write " << path << "\n";
+            }
+        }).detach();
+    });
+}
+
+void startPeriodicDumpFromEnv() {
+    const char* path = getenv("INVESTEDGE_METRICS_FILE");
+    if (!path || !*path) return;
+    const char* iv = getenv("INVESTEDGE_METRICS_INTERVAL");
+    startPeriodicDump(path, iv ? atof(iv) : 10.0);
+}
+
+} // namespace HotStats
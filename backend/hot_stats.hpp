@@ -0,0 +1,207 @@
+// hot_stats.hpp
+// Low-overhead instrumentation for the hot paths: counters and HDR-style
+// (log-linear) latency histograms. Every thread writes to its own shard
+// without locks or shared cache lines; shards are merged only when someone
+// reads (the `stats` command or the periodic Prometheus dump).
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace HotStats {
+
+// Building with INVESTEDGE_NO_STATS turns every update (Counter::inc,
+// Histogram::record, LocalCounter::inc) into a no-op while keeping the API,
+// so the same code can be timed with and without instrumentation. Define it
+// for a whole program, hot_stats.cpp included, never for single files.
+#ifdef INVESTEDGE_NO_STATS
+constexpr bool ENABLED = false;
+#else
+constexpr bool ENABLED = true;
+#endif
+
+/*===========================
+   Bucket Layout
+===========================*/
+// 16 linear sub-buckets per power of two (~6% relative error), values in
+// nanoseconds up to 2^40 (~18 minutes); larger values land in the last bucket.
+constexpr int SUB_BUCKETS   = 16;
+constexpr int SUB_BITS      = 4;
+constexpr int MAX_EXPONENT  = 40;
+constexpr int BUCKETS       = (MAX_EXPONENT - SUB_BITS + 2) * SUB_BUCKETS;
+constexpr int MAX_COUNTERS   = 64;
+constexpr int MAX_HISTOGRAMS = 32;
+
+inline int bucketIndex(uint64_t ns) {
+    if (ns < (uint64_t)SUB_BUCKETS) return (int)ns;
+    int exp = 63 - __builtin_clzll(ns);
+    if (exp > MAX_EXPONENT) return BUCKETS - 1;
+    int sub = (int)((ns >> (exp - SUB_BITS)) & (SUB_BUCKETS - 1));
+    return (exp - SUB_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+inline uint64_t bucketLowerBound(int idx) {
+    if (idx < SUB_BUCKETS) return (uint64_t)idx;
+    int exp = idx / SUB_BUCKETS + SUB_BITS - 1, sub = idx % SUB_BUCKETS;
+    return (1ull << exp) | ((uint64_t)sub << (exp - SUB_BITS));
+}
+
+inline uint64_t bucketUpperBound(int idx) {
+    return idx + 1 < BUCKETS ? bucketLowerBound(idx + 1) : UINT64_MAX;
+}
+
+inline int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*===========================
+   Per-Thread Shards
+===========================*/
+// Only the owning thread writes a shard, so updates are a relaxed load and
+// store (no locked instruction); readers merge with relaxed loads.
+struct HistogramShard {
+    std::atomic<uint64_t> buckets[BUCKETS];
+    std::atomic<uint64_t> count, sum, max;
+
+    HistogramShard();
+    void record(uint64_t ns) {
+        bump(buckets[bucketIndex(ns)], 1);
+        bump(count, 1);
+        bump(sum, ns);
+        if (ns > max.load(std::memory_order_relaxed)) max.store(ns, std::memory_order_relaxed);
+    }
+    static void bump(std::atomic<uint64_t>& a, uint64_t n) {
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+struct alignas(64) Shard {
+    std::atomic<uint64_t> counters[MAX_COUNTERS];
+    std::atomic<HistogramShard*> histograms[MAX_HISTOGRAMS];
+    Shard();
+};
+
+Shard* attachThread();               // registers the calling thread's shard
+inline thread_local Shard* tlsShard = nullptr;
+
+inline Shard& localShard() {
+    Shard* s = tlsShard;
+    return s ? *s : *attachThread();
+}
+
+HistogramShard& allocateHistogram(Shard& s, int id);
+
+/*===========================
+   Metric Handles
+===========================*/
+// Handles are cheap value types; register once (e.g. in a function-local
+// static) and use from any thread.
+class Counter {
+public:
+    int id = MAX_COUNTERS - 1;
+    void inc(uint64_t n = 1) const {
+        if constexpr (ENABLED) HistogramShard::bump(localShard().counters[id], n);
+    }
+};
+
+class Histogram {
+public:
+    int id = MAX_HISTOGRAMS - 1;
+    void record(uint64_t ns) const {
+        if constexpr (ENABLED) {
+            Shard& s = localShard();
+            HistogramShard* h = s.histograms[id].load(std::memory_order_relaxed);
+            (h ? *h : allocateHistogram(s, id)).record(ns);
+        }
+    }
+    void recordSince(int64_t startNs) const {
+        if constexpr (ENABLED) {
+            int64_t d = nowNanos() - startNs;
+            record(d < 0 ? 0 : (uint64_t)d);
+        }
+    }
+};
+
+// A counter embedded in an object that already serializes its own updates
+// (e.g. under its mutex), so an increment is a plain relaxed store with no
+// thread-local lookup. Live instances are summed into their Counter family
+// on read; a destroyed instance folds its total into the family first.
+class LocalCounter {
+    std::atomic<uint64_t> value{0};
+    int id;
+    size_t slot;                     // position in the registry, for O(1) removal
+public:
+    explicit LocalCounter(Counter family);
+    ~LocalCounter();
+    LocalCounter(const LocalCounter&) = delete;
+    LocalCounter& operator=(const LocalCounter&) = delete;
+
+    void inc(uint64_t n = 1) {
+        if constexpr (ENABLED)
+            value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    // For owners that already keep a running total: publish it when read
+    // rather than paying for an increment per event.
+    void set(uint64_t total) {
+        if constexpr (ENABLED) value.store(total, std::memory_order_relaxed);
+    }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+    int family() const { return id; }
+};
+
+// Records the lifetime of the scope into a histogram.
+class ScopedTimer {
+    const Histogram& hist;
+    int64_t start;
+public:
+    explicit ScopedTimer(const Histogram& h) : hist(h), start(ENABLED ? nowNanos() : 0) {}
+    ~ScopedTimer() { hist.recordSince(start); }
+};
+
+// `labels` is the Prometheus label body without braces, e.g. phase="curl".
+// Registering the same name+labels twice returns the same handle.
+Counter counter(const std::string& name, const std::string& labels, const std::string& help);
+Histogram histogram(const std::string& name, const std::string& labels, const std::string& help);
+
+/*===========================
+   Reading
+===========================*/
+struct HistogramSnapshot {
+    std::string name, labels, help;
+    std::vector<uint64_t> buckets;
+    uint64_t count = 0, sum = 0, max = 0;
+    uint64_t percentile(double p) const;   // nanoseconds
+};
+
+struct CounterSnapshot {
+    std::string name, labels, help;
+    uint64_t value = 0;
+};
+
+struct Snapshot {
+    double uptimeSeconds = 0;
+    std::vector<CounterSnapshot> counters;
+    std::vector<HistogramSnapshot> histograms;
+};
+
+Snapshot collect();                               // merges all shards
+void writePrometheus(std::ostream& out);          // text exposition format 0.0.4
+// Human-readable `stats` command. Sets `out`'s format flags while writing, so
+// a thread printing while others use the same stream should format into its
+// own ostringstream and write that under their shared output lock.
+void printStats(std::ostream& out);
+
+// Rewrites `path` every `intervalSeconds` (via rename, so scrapers never see
+// a partial file) from a background thread. Later calls are ignored.
+void startPeriodicDump(const std::string& path, double intervalSeconds);
+
+// Starts the dump if INVESTEDGE_METRICS_FILE is set; the interval comes from
+// INVESTEDGE_METRICS_INTERVAL (seconds, default 10).
+void startPeriodicDumpFromEnv();
+
+} // namespace HotStats
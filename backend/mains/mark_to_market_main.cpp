@@ -0,0 +1,11 @@
+// Minimal main that calls MarkToMarket::run(args)
+#include <iostream>
+#include <string>
+#include <vector>
+namespace MarkToMarket { void run(const std::vector<std::string>& args); }
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    try { MarkToMarket::run(args); }
+    catch (const std::exception& e) { std::cerr << "Fatal: " << e.what() << "\n"; return 1; }
+    return 0;
+}
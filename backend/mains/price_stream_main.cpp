@@ -0,0 +1,11 @@
+// Minimal main that calls PriceStream::run(args)
+#include <iostream>
+#include <string>
+#include <vector>
+namespace PriceStream { void run(const std::vector<std::string>& args); }
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    try { PriceStream::run(args); }
+    catch (const std::exception& e) { std::cerr << "Fatal: " << e.what() << "\n"; return 1; }
+    return 0;
+}
@@ -0,0 +1,10 @@
+// Minimal main that calls TickRingReader::run(ringName)
+#include <iostream>
+#include <string>
+namespace TickRingReader { void run(const std::string& ringName); }
+int main(int argc, char** argv) {
+    std::string ring = argc > 1 ? argv[1] : "/investedge_real_time_tracker";
+    try { TickRingReader::run(ring); }
+    catch (const std::exception& e) { std::cerr << "Fatal: " << e.what() << "\n"; return 1; }
+    return 0;
+}
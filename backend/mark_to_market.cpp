@@ -0,0 +1,644 @@
+// mark_to_market.cpp
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <unordered_map>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "mark_to_market.hpp"
+#include "rng.hpp"
+#include "backtester.hpp"
+#include "portfolio_analyzer.hpp"
+#include "profit_loss.hpp"
+
+using namespace std;
+
+namespace MarkToMarket {
+
+constexpr double FIXED_SCALE = 10000.0;
+constexpr size_t SYMBOL_CHARS = sizeof(TickRing::Record::symbol) - 1;
+
+static int64_t toFixed(double v) {
+    v *= FIXED_SCALE;
+    return (int64_t)(v < 0 ? v - 0.5 : v + 0.5);
+}
+
+static double fromFixed(int64_t v) { return (double)v / FIXED_SCALE; }
+
+/*===========================
+   Book
+===========================*/
+// Average-cost fill: the part of `qty` that reduces the position realizes
+// P&L against the average entry, any remainder opens at `price`.
+static void applyFill(Holding& h, int64_t qty, double price, double& realized) {
+    if (h.quantity == 0 || (h.quantity > 0) == (qty > 0)) {
+        h.quantity += qty;
+        h.costBasis += qty * price;
+        return;
+    }
+    int64_t closing = min(llabs(qty), llabs(h.quantity)) * (qty > 0 ? 1 : -1);
+    double avg = h.costBasis / h.quantity;
+    realized -= closing * (price - avg);
+    h.quantity += closing;
+    h.costBasis = h.quantity ? h.costBasis + closing * avg : 0.0;
+    if (qty != closing) applyFill(h, qty - closing, price, realized);
+}
+
+bool loadBook(const string& universePath, const string& ledgerPath, Book& out) {
+    if (PortfolioAnalyzer::stocks.empty() && !PortfolioAnalyzer::loadCSV(universePath)) return false;
+
+    ifstream in(ledgerPath);
+    if (!in.is_open()) {
+        cout << "Error: Could not open ledger " << ledgerPath << endl;
+        return false;
+    }
+
+    vector<Holding> held;
+    unordered_map<string, size_t> slot;
+    double realized = 0;
+    string line;
+    getline(in, line); // skip header
+    for (size_t row = 2; getline(in, line); row++) {
+        if (line.empty()) continue;
+        stringstream ss(line);
+        ProfitLossModule::ProfitLoss pl;
+        string qty, pr;
+        getline(ss, pl.stockname, ',');
+        getline(ss, pl.type, ',');
+        getline(ss, qty, ',');
+        getline(ss, pr, ',');
+        try {
+            pl.quantity = stoi(qty);
+            pl.price = stod(pr);
+        } catch (const exception&) {
+            cout << "Error: Bad ledger row " << row << " in " << ledgerPath << endl;
+            return false;
+        }
+
+        int64_t signedQty;
+        if (ProfitLossModule::isBuy(pl.type)) signedQty = pl.quantity;
+        else if (ProfitLossModule::isSell(pl.type)) signedQty = -(int64_t)pl.quantity;
+        else continue;
+
+        auto it = slot.find(pl.stockname);
+        if (it == slot.end()) {
+            it = slot.emplace(pl.stockname, held.size()).first;
+            held.push_back(Holding());
+            held.back().symbol = pl.stockname;
+        }
+        Holding& h = held[it->second];
+        applyFill(h, signedQty, pl.price, realized);
+        h.price = pl.price;
+    }
+
+    out = Book();
+    out.realized = realized;
+    for (Holding& h : held) {
+        if (h.quantity == 0) continue;
+        auto st = PortfolioAnalyzer::stockIndex.find(h.symbol);
+        if (st != PortfolioAnalyzer::stockIndex.end()) {
+            const PortfolioAnalyzer::Stock& s = PortfolioAnalyzer::stocks[st->second];
+            h.sector = s.sector;
+            h.price = s.price;
+        } else {
+            h.sector = "Unknown";
+        }
+        out.holdings.push_back(move(h));
+    }
+    return true;
+}
+
+Book generateBook(size_t positions, uint64_t seed) {
+    static const char* const sectors[] = {
+        "IT", "Technology", "Banking", "Automotive", "Pharma", "Energy", "FMCG", "Metals"};
+    Random::SplitMix64 rng(seed);
+
+    // Named like Backtester::generateTicks, so a generated book matches a
+    // generated tick file of that size.
+    Book b;
+    b.holdings.resize(positions);
+    for (size_t i = 0; i < positions; i++) {
+        Holding& h = b.holdings[i];
+        h.symbol = Backtester::symbolName((uint32_t)i, (uint32_t)positions);
+        h.sector = sectors[rng.next() % (sizeof(sectors) / sizeof(sectors[0]))];
+        h.price = 20.0 + 480.0 * rng.uniform();
+        h.quantity = 1 + (int64_t)rng.below(1000);
+        h.costBasis = h.quantity * h.price * (0.8 + 0.4 * rng.uniform());
+    }
+    return b;
+}
+
+bool saveBook(const string& universePath, const string& ledgerPath, const Book& book) {
+    ofstream uni(universePath), led(ledgerPath);
+    if (!uni.is_open() || !led.is_open()) {
+        cout << "Error: Could not write " << universePath << " / " << ledgerPath << endl;
+        return false;
+    }
+    uni << "symbol,name,sector,price,prev_close,market_cap\n";
+    led << "Stock Name,Type,Quantity,Price\n";
+    uni << fixed << setprecision(4);
+    led << fixed << setprecision(4);
+    for (const Holding& h : book.holdings) {
+        uni << h.symbol << "," << h.symbol << "," << h.sector << ","
+            << h.price << "," << h.price << ",0\n";
+        led << h.symbol << "," << (h.quantity > 0 ? "BUY" : "SELL") << ","
+            << llabs(h.quantity) << "," << h.costBasis / h.quantity << "\n";
+    }
+    return true;
+}
+
+/*===========================
+   Engine
+===========================*/
+static void symbolKey(const char* s, size_t len, uint64_t& lo, uint32_t& hi) {
+    char buf[sizeof(TickRing::Record::symbol)] = {};
+    memcpy(buf, s, min(len, SYMBOL_CHARS));
+    memcpy(&lo, buf, sizeof(lo));
+    memcpy(&hi, buf + sizeof(lo), sizeof(hi));
+}
+
+static uint64_t keyHash(uint64_t lo, uint32_t hi) {
+    return ((lo ^ ((uint64_t)hi << 29)) * 0x9e3779b97f4a7c15ull) >> 32;
+}
+
+HotStats::Counter Engine::tickCounter(const char* result) {
+    return HotStats::counter("investedge_mark_to_market_ticks_total",
+                             string("result=\"") + result + "\"",
+                             "Price ticks offered to the mark-to-market engine.");
+}
+
+Engine::Engine(const Book& book) {
+    uint64_t cap = 16;
+    while (cap < 2 * book.holdings.size()) cap <<= 1;
+    table.assign(cap, KeyEntry{0, 0, -1});
+    tableMask = cap - 1;
+
+    // Holdings of the same symbol are merged into one position.
+    vector<const Holding*> merged;
+    vector<int64_t> qty;
+    unordered_map<string, int> sectorIndex;
+    vector<int> sectorOfPos;
+    for (const Holding& h : book.holdings) {
+        uint64_t lo;
+        uint32_t hi;
+        symbolKey(h.symbol.data(), h.symbol.size(), lo, hi);
+        uint64_t i = keyHash(lo, hi) & tableMask;
+        while (table[i].position >= 0 && !(table[i].lo == lo && table[i].hi == hi))
+            i = (i + 1) & tableMask;
+        if (table[i].position >= 0) {
+            int p = table[i].position;
+            qty[p] += h.quantity;
+            costs[p] += h.costBasis;
+            merged[p] = &h;
+            continue;
+        }
+        table[i] = KeyEntry{lo, hi, (int32_t)merged.size()};
+
+        auto sec = sectorIndex.emplace(h.sector, (int)sectorNames.size());
+        if (sec.second) sectorNames.push_back(h.sector);
+        merged.push_back(&h);
+        qty.push_back(h.quantity);
+        costs.push_back(h.costBasis);
+        sectorOfPos.push_back(sec.first->second);
+    }
+
+    count = merged.size();
+    slots.reset(new Slot[count]);
+    sectorValue.reset(new atomic<int64_t>[sectorNames.size()]);
+    sectorCost.assign(sectorNames.size(), 0.0);
+    sectorPositions.assign(sectorNames.size(), 0);
+    for (size_t s = 0; s < sectorNames.size(); s++) sectorValue[s].store(0, memory_order_relaxed);
+
+    int64_t sum = 0;
+    for (size_t p = 0; p < count; p++) {
+        Slot& s = slots[p];
+        int64_t v = toFixed((double)qty[p] * merged[p]->price);
+        s.price.store(merged[p]->price, memory_order_relaxed);
+        s.value.store(v, memory_order_relaxed);
+        s.quantity = qty[p];
+        s.sector = sectorOfPos[p];
+        sectorValue[s.sector].store(sectorValue[s.sector].load(memory_order_relaxed) + v,
+                                    memory_order_relaxed);
+        sectorCost[s.sector] += costs[p];
+        sectorPositions[s.sector]++;
+        sum += v;
+        costTotal += costs[p];
+        symbols.push_back(merged[p]->symbol.substr(0, SYMBOL_CHARS));
+    }
+    total.store(sum, memory_order_relaxed);
+    realized = book.realized;
+    seq.store(0, memory_order_release);
+}
+
+int Engine::find(const char* symbol, size_t len) const {
+    uint64_t lo;
+    uint32_t hi;
+    symbolKey(symbol, len, lo, hi);
+    for (uint64_t i = keyHash(lo, hi) & tableMask;; i = (i + 1) & tableMask) {
+        const KeyEntry& e = table[i];
+        if (e.position < 0) return -1;
+        if (e.lo == lo && e.hi == hi) return e.position;
+    }
+}
+
+bool Engine::apply(int position, double price, int64_t tsNanos) {
+    if (position < 0 || (size_t)position >= count || !(price > 0) || !isfinite(price)) {
+        ignoredTicks.inc();
+        return false;
+    }
+    Slot& s = slots[position];
+    int64_t v = toFixed((double)s.quantity * price);
+    int64_t delta = v - s.value.load(memory_order_relaxed);
+    atomic<int64_t>& sv = sectorValue[s.sector];
+
+    uint64_t q = seq.load(memory_order_relaxed);
+    seq.store(q + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    s.price.store(price, memory_order_relaxed);
+    s.value.store(v, memory_order_relaxed);
+    sv.store(sv.load(memory_order_relaxed) + delta, memory_order_relaxed);
+    total.store(total.load(memory_order_relaxed) + delta, memory_order_relaxed);
+    ticks.store(ticks.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    lastTick.store(tsNanos, memory_order_relaxed);
+    seq.store(q + 2, memory_order_release);
+
+    appliedTicks.inc();
+    return true;
+}
+
+bool Engine::apply(const TickRing::Record& r) {
+    if (r.kind != TickRing::KIND_TICK) return false;     // trackers also publish stats per price
+    int p = find(r.symbol, strnlen(r.symbol, sizeof(r.symbol)));
+    if (p < 0) {
+        ignoredTicks.inc();
+        return false;
+    }
+    return apply(p, r.price, r.tsNanos);
+}
+
+// Runs `fn` (relaxed loads only) until it saw no update in progress.
+template <typename Fn>
+void Engine::readConsistent(Fn&& fn) const {
+    while (true) {
+        uint64_t s1 = seq.load(memory_order_acquire);
+        if (!(s1 & 1)) {
+            fn();
+            atomic_thread_fence(memory_order_acquire);
+            if (seq.load(memory_order_relaxed) == s1) return;
+        }
+        // The writer may be preempted mid-update; let it finish.
+        this_thread::yield();
+    }
+}
+
+Snapshot Engine::snapshot() const {
+    Snapshot out;
+    out.costBasis = costTotal;
+    out.realized = realized;
+    out.sectors.resize(sectorNames.size());
+    vector<int64_t> values(sectorNames.size());
+    int64_t sum = 0;
+
+    readConsistent([&] {
+        sum = total.load(memory_order_relaxed);
+        out.ticks = ticks.load(memory_order_relaxed);
+        out.lastTickNanos = lastTick.load(memory_order_relaxed);
+        for (size_t s = 0; s < values.size(); s++)
+            values[s] = sectorValue[s].load(memory_order_relaxed);
+    });
+
+    out.marketValue = fromFixed(sum);
+    for (size_t s = 0; s < values.size(); s++) {
+        SectorTotals& t = out.sectors[s];
+        t.sector = sectorNames[s];
+        t.positions = sectorPositions[s];
+        t.marketValue = fromFixed(values[s]);
+        t.costBasis = sectorCost[s];
+    }
+    return out;
+}
+
+bool Engine::position(const string& symbol, PositionView& out) const {
+    int p = find(symbol);
+    if (p < 0) return false;
+    const Slot& s = slots[p];
+    double price = 0;
+    int64_t value = 0;
+    readConsistent([&] {
+        price = s.price.load(memory_order_relaxed);
+        value = s.value.load(memory_order_relaxed);
+    });
+    out.symbol = symbols[p];
+    out.sector = sectorNames[s.sector];
+    out.quantity = s.quantity;
+    out.price = price;
+    out.marketValue = fromFixed(value);
+    out.costBasis = costs[p];
+    return true;
+}
+
+Snapshot Engine::recompute() const {
+    Snapshot out;
+    out.costBasis = costTotal;
+    out.realized = realized;
+    vector<int64_t> values(sectorNames.size());
+    int64_t sum = 0;
+
+    readConsistent([&] {
+        fill(values.begin(), values.end(), 0);
+        sum = 0;
+        for (size_t p = 0; p < count; p++) {
+            const Slot& s = slots[p];
+            int64_t v = toFixed((double)s.quantity * s.price.load(memory_order_relaxed));
+            values[s.sector] += v;
+            sum += v;
+        }
+        out.ticks = ticks.load(memory_order_relaxed);
+        out.lastTickNanos = lastTick.load(memory_order_relaxed);
+    });
+
+    out.marketValue = fromFixed(sum);
+    for (size_t s = 0; s < values.size(); s++)
+        out.sectors.push_back(SectorTotals{sectorNames[s], sectorPositions[s],
+                                           fromFixed(values[s]), sectorCost[s]});
+    return out;
+}
+
+/*===========================
+   Reports
+===========================*/
+void printSnapshot(const Snapshot& s) {
+    cout << "\nPortfolio Valuation (" << s.ticks << " ticks applied)\n";
+    cout << "----------------------------------------\n";
+    cout << fixed << setprecision(2);
+    cout << "Market Value    : " << s.marketValue << "\n";
+    cout << "Cost Basis      : " << s.costBasis << "\n";
+    cout << "Unrealized P&L  : " << s.unrealized() << "\n";
+    cout << "Realized P&L    : " << s.realized << "\n";
+
+    vector<const SectorTotals*> order;
+    for (const SectorTotals& t : s.sectors) order.push_back(&t);
+    sort(order.begin(), order.end(), [](const SectorTotals* a, const SectorTotals* b) {
+        return a->marketValue > b->marketValue;
+    });
+
+    cout << "\nSector           | Positions |     Market Value |   Unrealized P&L\n";
+    cout << "-------------------------------------------------------------------\n";
+    for (const SectorTotals* t : order)
+        cout << left << setw(16) << t->sector << " | " << right
+             << setw(9) << t->positions << " | "
+             << setw(16) << t->marketValue << " | "
+             << setw(16) << t->unrealized() << "\n";
+    cout << left;
+}
+
+static void printPosition(const PositionView& p) {
+    cout << fixed << setprecision(2);
+    cout << "\n" << p.symbol << " (" << p.sector << ")\n";
+    cout << "Quantity        : " << p.quantity << "\n";
+    cout << "Last Price      : " << p.price << "\n";
+    cout << "Market Value    : " << p.marketValue << "\n";
+    cout << "Unrealized P&L  : " << p.unrealized() << "\n";
+}
+
+/*===========================
+   Entry Points
+===========================*/
+namespace {
+
+// Applies every tick of a recorded tick file as fast as possible and checks
+// the incremental totals against a full re-sum of the book.
+void replay(Engine& e, const string& tickPath) {
+    Backtester::TickFile file;
+    if (!file.open(tickPath)) return;
+
+    vector<int> posOf(file.symbols.size());
+    size_t matched = 0;
+    for (size_t i = 0; i < posOf.size(); i++) {
+        posOf[i] = e.find(file.symbols[i]);
+        matched += posOf[i] >= 0;
+    }
+    cout << "Replaying " << file.count << " ticks (" << matched << " of "
+         << file.symbols.size() << " symbols held)...\n";
+
+    auto t0 = chrono::steady_clock::now();
+    for (size_t k = 0; k < file.count; k++) {
+        const Backtester::Tick& t = file.ticks[k];
+        e.apply(posOf[t.symbol], t.price, t.tsNanos);
+    }
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    Snapshot s = e.snapshot();
+    printSnapshot(s);
+    cout << "\nApplied " << s.ticks << " ticks (" << e.ignored() << " ignored) over "
+         << e.positions() << " positions in " << setprecision(3) << secs << " s ("
+         << setprecision(1) << (file.count ? secs * 1e9 / file.count : 0.0) << " ns/tick)\n";
+
+    Snapshot full = e.recompute();
+    if (full.marketValue == s.marketValue)
+        cout << "Incremental totals match a full re-sum of the book.\n";
+    else
+        cout << "Error: incremental total " << s.marketValue << " differs from re-sum "
+             << full.marketValue << "\n";
+}
+
+// Follows a tracker's tick ring for `seconds` (0 = until killed); a reader
+// thread prints the totals every `interval` seconds while ticks stream in.
+void follow(Engine& e, const string& ringName, double seconds, double interval) {
+    static const HotStats::Histogram lag = HotStats::histogram(
+        "investedge_mark_to_market_lag_seconds", "",
+        "Delay from a tick being published to the ring to the portfolio totals reflecting it.");
+
+    atomic<bool> done{false};
+    thread reporter([&] {
+        auto nextReport = chrono::steady_clock::now() + chrono::duration<double>(interval);
+        while (!done.load()) {
+            this_thread::sleep_for(chrono::milliseconds(50));
+            if (chrono::steady_clock::now() < nextReport) continue;
+            nextReport += chrono::duration_cast<chrono::steady_clock::duration>(
+                chrono::duration<double>(interval));
+            Snapshot s = e.snapshot();
+            cout << fixed << setprecision(2) << "[" << s.ticks << " ticks] value "
+                 << s.marketValue << " | unrealized " << s.unrealized() << endl;
+        }
+    });
+
+    if (!TickRing::hasProducer(ringName))
+        cout << "No tracker is publishing to " << ringName << " yet. Waiting for one "
+             << "(real_time_tracker, real_time_tracker_with_risk or price_stream).\n";
+
+    TickRing::Consumer consumer;
+    auto end = chrono::steady_clock::now() + chrono::duration<double>(seconds);
+    while (seconds <= 0 || chrono::steady_clock::now() < end) {
+        if (!consumer.isOpen() || consumer.isStale()) {
+            if (!consumer.open(ringName)) {
+                this_thread::sleep_for(chrono::milliseconds(500));
+                continue;
+            }
+            cerr << "Attached to " << ringName << "\n";
+        }
+        size_t n = consumer.poll([&](const TickRing::Record& r) {
+            if (e.apply(r)) lag.recordSince(r.tsNanos);
+        });
+        if (n == 0) this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    done = true;
+    reporter.join();
+    if (consumer.lost()) cout << consumer.lost() << " records were overrun in the ring\n";
+    printSnapshot(e.snapshot());
+}
+
+// Ring to follow when none is named: the one the dashboard hands over in
+// INVESTEDGE_FOLLOW_RING while it is live, else the only live tracker ring.
+// With several live rings, `ask` lists them and reads a choice; otherwise
+// they are listed for --ring. Empty when there is nothing to follow.
+string pickRing(bool ask) {
+    const char* env = getenv("INVESTEDGE_FOLLOW_RING");
+    if (env && *env && TickRing::hasProducer(env)) return env;
+
+    vector<string> rings = TickRing::liveRings();
+    if (rings.empty()) {
+        cout << "No tracker is publishing ticks. Start real_time_tracker, "
+             << "real_time_tracker_with_risk or price_stream first.\n";
+        return "";
+    }
+    if (rings.size() == 1) return rings[0];
+
+    cout << "Live tick rings:\n";
+    for (size_t i = 0; i < rings.size(); i++) cout << "  " << i + 1 << ". " << rings[i] << "\n";
+    if (!ask) {
+        cout << "Choose one with --ring=\n";
+        return "";
+    }
+    size_t k;
+    cout << "Ring to follow: ";
+    if (!(cin >> k) || k < 1 || k > rings.size()) {
+        cout << "Invalid choice!\n";
+        return "";
+    }
+    return rings[k - 1];
+}
+
+} // namespace
+
+void run(const vector<string>& args) {
+    if (args.empty()) {
+        run();
+        return;
+    }
+
+    string cmd = args[0], universe = "portfolio.csv", ledger = ProfitLossModule::Fhistory, ticks;
+    string ring;
+    size_t positions = 50000;
+    uint64_t count = 10000000;
+    double seconds = 0, interval = 1;
+
+    for (size_t i = 1; i < args.size(); i++) {
+        const string& a = args[i];
+        size_t eq = a.find('=');
+        string key = a.substr(0, eq), val = eq == string::npos ? "" : a.substr(eq + 1);
+        if (key == "--universe") universe = val;
+        else if (key == "--ledger") ledger = val;
+        else if (key == "--ticks") ticks = val;
+        else if (key == "--ring") ring = val;
+        else if (key == "--positions") positions = stoul(val);
+        else if (key == "--count") count = stoull(val);
+        else if (key == "--seconds") seconds = stod(val);
+        else if (key == "--interval") interval = max(0.1, stod(val));
+        else { cout << "Unknown option " << a << "\n"; return; }
+    }
+
+    if (cmd == "generate") {
+        if (ticks.empty()) ticks = "ticks.bin";
+        if (!saveBook(universe, ledger, generateBook(positions))) return;
+        if (!Backtester::generateTicks(ticks, (uint32_t)min<size_t>(positions, 100000), count)) return;
+        cout << "Wrote " << positions << " positions to " << universe << " + " << ledger
+             << " and " << count << " ticks to " << ticks << "\n";
+        return;
+    }
+
+    if (cmd != "show" && cmd != "replay" && cmd != "follow") {
+        cout << "Usage:\n"
+             << "  mark_to_market generate --universe=book.csv --ledger=book_ledger.csv [--ticks=ticks.bin]\n"
+             << "                          [--positions=50000] [--count=10000000]\n"
+             << "  mark_to_market show|replay|follow [options]\n"
+             << "    --universe=portfolio.csv --ledger=History.csv\n"
+             << "    --ticks=ticks.bin (replay)\n"
+             << "    --ring=/investedge_real_time_tracker --seconds=0 --interval=1 (follow;\n"
+             << "      without --ring, the only live tracker ring)\n";
+        return;
+    }
+
+    Book book;
+    if (!loadBook(universe, ledger, book)) return;
+    Engine e(book);
+    cout << "Loaded " << e.positions() << " open positions from " << ledger << "\n";
+
+    if (cmd == "show") printSnapshot(e.snapshot());
+    else if (cmd == "replay") replay(e, ticks);
+    else {
+        if (ring.empty() && (ring = pickRing(false)).empty()) return;
+        HotStats::startPeriodicDumpFromEnv();
+        follow(e, ring, seconds, interval);
+    }
+}
+
+void run() {
+    Book book;
+    if (!loadBook("portfolio.csv", ProfitLossModule::Fhistory, book)) {
+        cout << "Please create portfolio.csv and record trades in the Profit & Loss module first!\n";
+        return;
+    }
+    Engine e(book);
+    HotStats::startPeriodicDumpFromEnv();
+    cout << "Loaded " << e.positions() << " open positions from " << ProfitLossModule::Fhistory << "\n";
+
+    while (true) {
+        cout << "\n=========== Mark to Market ===========\n";
+        cout << "1. Show Valuation\n";
+        cout << "2. Look Up Position\n";
+        cout << "3. Follow Real-Time Tracker\n";
+        cout << "4. Replay Tick File\n";
+        cout << "5. Show Stats\n";
+        cout << "0. Exit\n";
+        cout << "--------------------------------------\n";
+        cout << "Enter choice: ";
+
+        int ch;
+        if (!(cin >> ch) || ch == 0) break;
+
+        if (ch == 1) printSnapshot(e.snapshot());
+        else if (ch == 2) {
+            string sym;
+            PositionView p;
+            cout << "Stock symbol: ";
+            cin >> sym;
+            if (e.position(sym, p)) printPosition(p);
+            else cout << "No open position in " << sym << "\n";
+        } else if (ch == 3) {
+            string ring = pickRing(true);
+            if (ring.empty()) continue;
+            double seconds;
+            cout << "Follow " << ring << " for how many seconds? ";
+            cin >> seconds;
+            follow(e, ring, max(seconds, 1.0), 1.0);
+        } else if (ch == 4) {
+            string file;
+            cout << "Tick file: ";
+            cin >> file;
+            replay(e, file);
+        } else if (ch == 5) HotStats::printStats(cout);
+        else cout << "Invalid choice! Try again.\n";
+    }
+}
+
+} // namespace MarkToMarket
@@ -0,0 +1,148 @@
+// mark_to_market.hpp
+// Live valuation of the Profit & Loss holdings. Each price tick reprices one
+// position and adds the change in its value to its sector and portfolio
+// totals, so a tick costs the same at 50 positions or 50k. Readers take
+// consistent snapshots of the totals from any thread without ever blocking
+// the ingesting thread.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "hot_stats.hpp"
+#include "tick_ring.hpp"
+
+namespace MarkToMarket {
+
+/*===========================
+   Book
+===========================*/
+// Net position per symbol after replaying the ledger with average cost.
+struct Holding {
+    std::string symbol, sector;
+    int64_t quantity = 0;       // negative = short
+    double costBasis = 0;       // quantity × average entry price
+    double price = 0;           // initial mark
+};
+
+struct Book {
+    std::vector<Holding> holdings;
+    double realized = 0;        // P&L of the ledger's closed quantity
+};
+
+// Sectors and opening marks come from portfolio.csv; quantities from a
+// History.csv ledger. Ledger symbols missing from the universe are marked
+// at their last fill in sector "Unknown".
+bool loadBook(const std::string& universePath, const std::string& ledgerPath, Book& out);
+
+// Synthetic long book with symbols T00000.. (the names Backtester::generateTicks uses).
+Book generateBook(size_t positions, uint64_t seed = 42);
+
+// Writes the book as a universe CSV and a one-BUY-per-holding ledger.
+bool saveBook(const std::string& universePath, const std::string& ledgerPath, const Book& book);
+
+/*===========================
+   Snapshots
+===========================*/
+struct SectorTotals {
+    std::string sector;
+    size_t positions = 0;
+    double marketValue = 0, costBasis = 0;
+    double unrealized() const { return marketValue - costBasis; }
+};
+
+struct Snapshot {
+    uint64_t ticks = 0;          // ticks applied so far
+    int64_t lastTickNanos = 0;   // publish time of the latest applied tick
+    double marketValue = 0, costBasis = 0, realized = 0;
+    std::vector<SectorTotals> sectors;
+    double unrealized() const { return marketValue - costBasis; }
+};
+
+struct PositionView {
+    std::string symbol, sector;
+    int64_t quantity = 0;
+    double price = 0, marketValue = 0, costBasis = 0;
+    double unrealized() const { return marketValue - costBasis; }
+};
+
+/*===========================
+   Engine
+===========================*/
+class Engine {
+public:
+    explicit Engine(const Book& book);
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    // Position index for a symbol (truncated to 11 chars like ring records), or -1.
+    int find(const char* symbol, size_t len) const;
+    int find(const std::string& symbol) const { return find(symbol.data(), symbol.size()); }
+
+    // Reprices one position. Single writer: call from one ingesting thread.
+    // Non-positive or non-finite prices are ignored.
+    bool apply(int position, double price, int64_t tsNanos);
+    // Only KIND_TICK records reprice; stats records are skipped, not counted.
+    bool apply(const TickRing::Record& r);
+
+    // Safe from any thread, concurrently with apply().
+    Snapshot snapshot() const;
+    bool position(const std::string& symbol, PositionView& out) const;
+
+    // Full re-sum of every position, for checking the incremental totals.
+    Snapshot recompute() const;
+
+    size_t positions() const { return count; }
+    uint64_t ignored() const { return ignoredTicks.get(); }
+
+private:
+    // Values are kept in fixed point (1/10000 of a currency unit) so that
+    // applying deltas is exact and the running totals never drift from the
+    // sum of the positions, however many ticks arrive.
+    struct alignas(32) Slot {
+        std::atomic<double> price;
+        std::atomic<int64_t> value;
+        int64_t quantity;
+        int32_t sector;
+    };
+    struct KeyEntry {
+        uint64_t lo;
+        uint32_t hi;
+        int32_t position;       // -1 = empty
+    };
+
+    size_t count = 0;
+    std::unique_ptr<Slot[]> slots;
+    std::vector<std::string> symbols, sectorNames;
+    std::vector<double> costs, sectorCost;
+    std::vector<size_t> sectorPositions;
+    std::vector<KeyEntry> table;
+    uint64_t tableMask = 0;
+    double costTotal = 0, realized = 0;
+
+    // Written only by the ingesting thread; readers retry while `seq` is odd
+    // or changes under them (seqlock).
+    alignas(64) std::atomic<uint64_t> seq{0};
+    std::atomic<int64_t> total{0};
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<int64_t> lastTick{0};
+    std::unique_ptr<std::atomic<int64_t>[]> sectorValue;
+
+    HotStats::LocalCounter appliedTicks{tickCounter("applied")};
+    HotStats::LocalCounter ignoredTicks{tickCounter("ignored")};
+
+    static HotStats::Counter tickCounter(const char* result);
+    template <typename Fn> void readConsistent(Fn&& fn) const;
+};
+
+/*===========================
+   Entry Points
+===========================*/
+void printSnapshot(const Snapshot& s);
+
+void run(const std::vector<std::string>& args);   // CLI mode
+void run();                                        // interactive menu
+
+} // namespace MarkToMarket
@@ -0,0 +1,117 @@
+// parallel.hpp
+// Data-parallel loops over a process-wide pool of worker threads. Workers
+// are started on first use and parked on a condition variable between
+// loops, so an iterative solver can fan out every iteration without paying
+// for thread creation each time.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Parallel {
+
+// 0 means one thread per hardware thread.
+inline unsigned threadCount(unsigned requested) {
+    return requested ? requested : std::max(1u, std::thread::hardware_concurrency());
+}
+
+class Pool {
+    std::mutex runLock;                 // one loop at a time
+    std::mutex m;
+    std::condition_variable wake, idle;
+    std::vector<std::thread> workers;
+    uint64_t generation = 0;
+    unsigned helpers = 0, busy = 0;     // workers taking part in the current loop
+    bool stopping = false;
+
+    void (*call)(const void*, size_t) = nullptr;
+    const void* ctx = nullptr;
+    size_t jobs = 0;
+    std::atomic<size_t> next{0};
+
+    static bool& insideWorker() {
+        static thread_local bool inside = false;
+        return inside;
+    }
+
+    void drain() {
+        for (size_t j; (j = next.fetch_add(1)) < jobs;) call(ctx, j);
+    }
+
+    void work(unsigned index) {
+        insideWorker() = true;
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lk(m);
+        for (;;) {
+            wake.wait(lk, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            if (index >= helpers) continue;
+            lk.unlock();
+            drain();
+            lk.lock();
+            if (--busy == 0) idle.notify_one();
+        }
+    }
+
+public:
+    Pool() = default;
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+    ~Pool() {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& th : workers) th.join();
+    }
+
+    static Pool& shared() {
+        static Pool pool;
+        return pool;
+    }
+
+    // Runs fn(0..jobs-1) on the caller plus up to `threads - 1` workers
+    // pulling from a shared counter. A single thread, a single job or a call
+    // from inside a worker runs inline.
+    template <typename Fn>
+    void run(size_t count, unsigned threads, const Fn& fn) {
+        threads = (unsigned)std::min<size_t>(threads, count);
+        if (threads <= 1 || insideWorker()) {
+            for (size_t j = 0; j < count; j++) fn(j);
+            return;
+        }
+        std::lock_guard<std::mutex> serial(runLock);
+        {
+            std::lock_guard<std::mutex> lk(m);
+            while (workers.size() < threads - 1) {
+                unsigned index = (unsigned)workers.size();
+                workers.emplace_back([this, index] { work(index); });
+            }
+            call = [](const void* c, size_t j) { (*static_cast<const Fn*>(c))(j); };
+            ctx = &fn;
+            jobs = count;
+            next.store(0);
+            helpers = busy = threads - 1;
+            generation++;
+        }
+        wake.notify_all();
+        drain();
+        std::unique_lock<std::mutex> lk(m);
+        idle.wait(lk, [&] { return busy == 0; });
+    }
+};
+
+template <typename Fn>
+void parallelFor(size_t jobs, unsigned threads, const Fn& fn) {
+    Pool::shared().run(jobs, threads, fn);
+}
+
+} // namespace Parallel
@@ -9,19 +9,17 @@
 #include <sstream>
 #include <numeric>
 #include <iomanip>
+#include <limits>
+#include <chrono>
+#include <cstdlib>
+#include "portfolio_analyzer.hpp"
+#include "hot_stats.hpp"
+#include "stock_screener.hpp"
 
 using namespace std;
 
 namespace PortfolioAnalyzer {
 
-/*===========================
-   Stock Data Structure
-===========================*/
-struct Stock {
-    string symbol, name, sector;
-    double price{}, prevClose{}, changePercent{}, marketCap{};
-};
-
 /*===========================
    Global Containers
 ===========================*/
@@ -33,6 +31,12 @@ unordered_map<string, vector<string>> sectorGraph;
    Load CSV File
 ===========================*/
 bool loadCSV(const string &file) {
+    static const HotStats::Histogram loadTime = HotStats::histogram(
+        "investedge_load_csv_seconds", "", "Time to load the stock universe CSV.");
+    static const HotStats::Counter rowsLoaded = HotStats::counter(
+        "investedge_csv_rows_total", "", "Stocks loaded from CSV.");
+    HotStats::ScopedTimer timer(loadTime);
+
     ifstream in(file);
     if (!in.is_open()) {
         cout << "Error: Could not open file " << file << endl;
@@ -66,6 +70,7 @@ bool loadCSV(const string &file) {
 
         stockIndex[s.symbol] = stocks.size();
         stocks.push_back(s);
+        rowsLoaded.inc();
     }
     return true;
 }
@@ -196,6 +201,46 @@ void lookupStock() {
     cout << "Change : " << s.changePercent << "%\n";
 }
 
+/*===========================
+   Screen Stocks
+===========================*/
+void screenStocks() {
+    static StockScreener::Table table;
+    if (table.rows != stocks.size() || table.source != &stocks)
+        table = StockScreener::buildTable(stocks);
+
+    string expr, sortSpec, limitText;
+    cout << "Fields: price, prevClose, changePercent, marketCap, sector, symbol, name\n";
+    cout << "Filter (e.g. sector == \"IT\" && changePercent > 1.5, blank = all): ";
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, expr);
+    cout << "Sort by (e.g. -changePercent, blank = none): ";
+    getline(cin, sortSpec);
+    cout << "Max results (blank = 20): ";
+    getline(cin, limitText);
+
+    StockScreener::Order order;
+    if (!StockScreener::parseOrder(sortSpec, order)) return;
+    // Blank means 20. Anything but a whole number is refused: strtoul would
+    // read it as 0, which means every match.
+    size_t first = limitText.find_first_not_of(" \t"), last = limitText.find_last_not_of(" \t");
+    string digits = first == string::npos ? "" : limitText.substr(first, last - first + 1);
+    if (digits.find_first_not_of("0123456789") != string::npos) {
+        cout << "Error: Max results must be a whole number\n";
+        return;
+    }
+    order.limit = digits.empty() ? 20 : strtoul(digits.c_str(), nullptr, 10);
+
+    vector<uint32_t> rows;
+    size_t matches = 0;
+    auto t0 = chrono::steady_clock::now();
+    if (!StockScreener::screen(table, expr, order, rows, matches)) return;
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+    StockScreener::printMatches(table, rows, matches);
+    cout << "Screened in " << fixed << setprecision(2) << ms << " ms\n";
+}
+
 /*===========================
            Menu
 ===========================*/
@@ -206,6 +251,8 @@ void menu() {
         cout << "2. Top Gainers / Losers\n";
         cout << "3. Show Rankings\n";
         cout << "4. Show Sector Graph\n";
+        cout << "5. Show Stats\n";
+        cout << "6. Screen Stocks\n";
         cout << "0. Exit\n";
         cout << "-----------------------------------------\n";
         cout << "Enter choice: ";
@@ -222,6 +269,8 @@ void menu() {
             showTopMovers(k);
         } else if (ch == 3) showRankings();
         else if (ch == 4) printSectorGraph();
+        else if (ch == 5) HotStats::printStats(cout);
+        else if (ch == 6) screenStocks();
         else cout << "Invalid choice! Try again.\n";
     }
 }
@@ -231,6 +280,7 @@ void menu() {
 ===========================*/
 void run() {
     string file = "portfolio.csv";
+    HotStats::startPeriodicDumpFromEnv();
 
     if (!loadCSV(file)) {
         cout << "Please create portfolio.csv first!\n";
@@ -0,0 +1,35 @@
+// portfolio_analyzer.hpp
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace PortfolioAnalyzer {
+
+/*===========================
+   Stock Data Structure
+===========================*/
+struct Stock {
+    std::string symbol, name, sector;
+    double price{}, prevClose{}, changePercent{}, marketCap{};
+};
+
+/*===========================
+   Global Containers
+===========================*/
+extern std::vector<Stock> stocks;
+extern std::unordered_map<std::string, int> stockIndex;
+extern std::unordered_map<std::string, std::vector<std::string>> sectorGraph;
+
+bool loadCSV(const std::string &file);
+void showTopMovers(int k);
+void showRankings();
+void buildSectorGraph();
+void printSectorGraph();
+void lookupStock();
+void screenStocks();
+void menu();
+void run();
+
+} // namespace PortfolioAnalyzer
@@ -0,0 +1,1101 @@
+// portfolio_optimizer.cpp
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include "portfolio_optimizer.hpp"
+#include "parallel.hpp"
+#include "rng.hpp"
+#include "portfolio_analyzer.hpp"
+#include "hot_stats.hpp"
+
+using namespace std;
+
+namespace PortfolioOptimizer {
+
+using Parallel::parallelFor;
+using Parallel::threadCount;
+
+/*===========================
+   Price History
+===========================*/
+bool loadPriceHistory(const string& path, PriceHistory& out) {
+    ifstream in(path);
+    if (!in.is_open()) {
+        cout << "Error: Could not open file " << path << endl;
+        return false;
+    }
+
+    out = PriceHistory{};
+    string line, cell;
+    getline(in, line);
+    stringstream header(line);
+    getline(header, cell, ',');                     // "date"
+    while (getline(header, cell, ',')) out.symbols.push_back(cell);
+
+    size_t n = out.symbols.size();
+    while (getline(in, line)) {
+        if (line.empty()) continue;
+        stringstream ss(line);
+        string date;
+        getline(ss, date, ',');
+        size_t start = out.prices.size();
+        while (getline(ss, cell, ',')) {
+            char* end = nullptr;
+            double v = strtod(cell.c_str(), &end);
+            out.prices.push_back(end != cell.c_str() ? v : NAN);   // gaps become NaN
+        }
+        out.prices.resize(start + n, NAN);
+        out.dates.push_back(date);
+    }
+    return true;
+}
+
+bool savePriceHistory(const string& path, const PriceHistory& h) {
+    ofstream out(path);
+    if (!out.is_open()) {
+        cout << "Error: Could not write " << path << endl;
+        return false;
+    }
+    out << "date";
+    for (auto& s : h.symbols) out << "," << s;
+    out << "\n" << fixed << setprecision(4);
+    for (size_t k = 0; k < h.periods(); k++) {
+        out << h.dates[k];
+        for (size_t i = 0; i < h.assets(); i++) out << "," << h.prices[k * h.assets() + i];
+        out << "\n";
+    }
+    return true;
+}
+
+PriceHistory generatePriceHistory(const vector<string>& symbols, const vector<string>& sectorNames,
+                                  const vector<double>& lastPrices, size_t periods, uint64_t seed) {
+    Random::SplitMix64 rng(seed);
+
+    size_t n = symbols.size();
+    vector<string> names;
+    vector<int> sec(n);
+    for (size_t i = 0; i < n; i++) {
+        auto it = find(names.begin(), names.end(), sectorNames[i]);
+        sec[i] = (int)(it - names.begin());
+        if (it == names.end()) names.push_back(sectorNames[i]);
+    }
+
+    // r = drift + β·market + sector + idiosyncratic, daily scale.
+    vector<double> drift(n), beta(n), idio(n);
+    for (size_t i = 0; i < n; i++) {
+        drift[i] = 0.0004 + 0.0006 * rng.normal();
+        beta[i] = 0.6 + 0.8 * rng.uniform();
+        idio[i] = 0.008 + 0.012 * rng.uniform();
+    }
+
+    PriceHistory h;
+    h.symbols = symbols;
+    h.prices.assign(periods * n, 0.0);
+    vector<double> logp(n, 0.0), sectorMove(names.size());
+    for (size_t k = 0; k < periods; k++) {
+        if (k > 0) {
+            double market = 0.009 * rng.normal();
+            for (auto& s : sectorMove) s = 0.006 * rng.normal();
+            for (size_t i = 0; i < n; i++)
+                logp[i] += drift[i] + beta[i] * market + sectorMove[sec[i]] + idio[i] * rng.normal();
+        }
+        for (size_t i = 0; i < n; i++) h.prices[k * n + i] = logp[i];
+    }
+    for (size_t i = 0; i < n; i++) {
+        double shift = log(lastPrices[i] > 0 ? lastPrices[i] : 100.0) - logp[i];
+        for (size_t k = 0; k < periods; k++) h.prices[k * n + i] = exp(h.prices[k * n + i] + shift);
+    }
+
+    // Business days ending today.
+    time_t day = time(nullptr);
+    vector<string> dates;
+    while (dates.size() < periods) {
+        tm local = *localtime(&day);
+        if (local.tm_wday != 0 && local.tm_wday != 6) {
+            char buf[16];
+            strftime(buf, sizeof(buf), "%Y-%m-%d", &local);
+            dates.push_back(buf);
+        }
+        day -= 86400;
+    }
+    h.dates.assign(dates.rbegin(), dates.rend());
+    return h;
+}
+
+/*===========================
+   Blocked Covariance Kernel
+===========================*/
+constexpr size_t TILE = 64;      // assets per panel; a 64×64 result tile is 32 KB
+constexpr size_t MICRO_I = 4;
+constexpr size_t MICRO_J = 8;
+
+void crossProducts(const double* r, size_t t, size_t n, double* cross, unsigned threads) {
+    size_t panels = (n + TILE - 1) / TILE;
+
+    // Pack each 64-asset column panel contiguously (t × 64, zero padded) so
+    // a tile streams two dense panels instead of striding across R.
+    vector<double> packed(panels * t * TILE, 0.0);
+    parallelFor(panels, threads, [&](size_t b) {
+        size_t c0 = b * TILE, w = min(TILE, n - c0);
+        double* p = &packed[b * t * TILE];
+        for (size_t k = 0; k < t; k++) memcpy(p + k * TILE, r + k * n + c0, w * sizeof(double));
+    });
+
+    vector<pair<uint32_t, uint32_t>> tiles;
+    for (size_t bi = 0; bi < panels; bi++)
+        for (size_t bj = bi; bj < panels; bj++) tiles.push_back({(uint32_t)bi, (uint32_t)bj});
+
+    parallelFor(tiles.size(), threads, [&](size_t id) {
+        size_t bi = tiles[id].first, bj = tiles[id].second;
+        const double* a = &packed[bi * t * TILE];
+        const double* b = &packed[bj * t * TILE];
+        alignas(64) double c[TILE * TILE];
+
+        // 4×8 register block accumulated over all periods; the inner j loop
+        // is contiguous and vectorizes without reassociating any sum.
+        for (size_t i0 = 0; i0 < TILE; i0 += MICRO_I) {
+            for (size_t j0 = 0; j0 < TILE; j0 += MICRO_J) {
+                double acc[MICRO_I][MICRO_J] = {};
+                for (size_t k = 0; k < t; k++) {
+                    const double* ak = a + k * TILE + i0;
+                    const double* bk = b + k * TILE + j0;
+                    for (size_t ii = 0; ii < MICRO_I; ii++)
+                        for (size_t jj = 0; jj < MICRO_J; jj++) acc[ii][jj] += ak[ii] * bk[jj];
+                }
+                for (size_t ii = 0; ii < MICRO_I; ii++)
+                    for (size_t jj = 0; jj < MICRO_J; jj++) c[(i0 + ii) * TILE + j0 + jj] = acc[ii][jj];
+            }
+        }
+
+        size_t r0 = bi * TILE, c0 = bj * TILE;
+        size_t rows = min(TILE, n - r0), cols = min(TILE, n - c0);
+        for (size_t i = 0; i < rows; i++)
+            for (size_t j = 0; j < cols; j++) {
+                cross[(r0 + i) * n + c0 + j] = c[i * TILE + j];
+                cross[(c0 + j) * n + r0 + i] = c[i * TILE + j];
+            }
+    });
+}
+
+/*===========================
+   Build & Incremental Updates
+===========================*/
+bool Optimizer::build(const PriceHistory& history, const unordered_map<string, string>& sectorOf,
+                      const Options& options) {
+    static const HotStats::Histogram buildTime = HotStats::histogram(
+        "investedge_optimizer_seconds", "phase=\"covariance\"", "Portfolio optimizer time by phase.");
+    HotStats::ScopedTimer timer(buildTime);
+
+    opt = options;
+    if (opt.shrinkage < 0 || opt.shrinkage > 1) {
+        cout << "Error: Shrinkage must be between 0 and 1\n";
+        return false;
+    }
+    size_t periods = history.periods(), all = history.assets();
+    if (periods < 3) {
+        cout << "Error: Need at least 3 price rows, found " << periods << "\n";
+        return false;
+    }
+
+    // Keep assets with a complete, positive price series.
+    vector<size_t> keep;
+    for (size_t i = 0; i < all; i++) {
+        bool ok = true;
+        for (size_t k = 0; k < periods && ok; k++) {
+            double p = history.prices[k * all + i];
+            ok = p > 0 && isfinite(p);
+        }
+        if (ok) keep.push_back(i);
+    }
+    if (keep.size() < all)
+        cout << "Skipping " << all - keep.size() << " assets with missing or non-positive prices\n";
+    if (keep.empty()) {
+        cout << "Error: No assets with a complete price history\n";
+        return false;
+    }
+
+    n = keep.size();
+    t = periods - 1;
+    syms.clear(); sectors.clear(); sector.assign(n, 0); index.clear();
+    for (size_t a = 0; a < n; a++) {
+        syms.push_back(history.symbols[keep[a]]);
+        index[syms[a]] = a;
+        auto it = sectorOf.find(syms[a]);
+        string name = it == sectorOf.end() ? "Unknown" : it->second;
+        auto s = find(sectors.begin(), sectors.end(), name);
+        sector[a] = (int)(s - sectors.begin());
+        if (s == sectors.end()) sectors.push_back(name);
+    }
+    caps.assign(sectors.size(), opt.defaultSectorCap);
+    for (auto& p : opt.sectorCaps) {
+        auto s = find(sectors.begin(), sectors.end(), p.first);
+        if (s != sectors.end()) caps[s - sectors.begin()] = p.second;
+    }
+
+    returns.assign(t * n, 0.0);
+    prevPrice.assign(n, 0.0);
+    for (size_t k = 0; k < t; k++)
+        for (size_t a = 0; a < n; a++)
+            returns[k * n + a] = history.prices[(k + 1) * all + keep[a]] / history.prices[k * all + keep[a]] - 1.0;
+    for (size_t a = 0; a < n; a++) prevPrice[a] = history.prices[(periods - 2) * all + keep[a]];
+
+    colSum.assign(n, 0.0);
+    for (size_t k = 0; k < t; k++)
+        for (size_t a = 0; a < n; a++) colSum[a] += returns[k * n + a];
+
+    // RᵀR lands in cov and becomes the sample covariance in place; the
+    // mirrored tiles are bit-identical, so Σ stays exactly symmetric.
+    cov.assign(n * n, 0.0);
+    crossProducts(returns.data(), t, n, cov.data(), threadCount(opt.threads));
+    double inv = 1.0 / (double)(t - 1), invT = 1.0 / (double)t;
+    mu.assign(n, 0.0);
+    rowAbs.assign(n, 0.0);
+    parallelFor(n, threadCount(opt.threads), [&](size_t i) {
+        double* row = &cov[i * n];
+        double total = 0;
+        for (size_t j = 0; j < n; j++) {
+            row[j] = (row[j] - colSum[i] * colSum[j] * invT) * inv;
+            total += fabs(row[j]);
+        }
+        rowAbs[i] = total - fabs(row[i]);
+        mu[i] = colSum[i] * invT;
+    });
+    estimateLipschitz();
+
+    warmMinVar.clear(); warmSharpe.clear(); warmTarget.clear(); warmFrontier.clear();
+    sharpeLambda = 0;
+
+    double capTotal = 0;
+    for (double c : caps) capTotal += c;
+    if (capTotal < 1.0 - 1e-12) {
+        cout << "Error: Sector caps add up to " << capTotal << " < 1; no portfolio is feasible\n";
+        return false;
+    }
+    return true;
+}
+
+// Σ_s y with Σ_s = (1 − δ)·Σ + δ·diag(Σ). Through the returns when that is
+// cheaper (Σ = (RᵀR − ssᵀ/t)/(t − 1), 2·t·n work), else row by row.
+void Optimizer::multiply(const double* y, double* g) const {
+    double keepOff = 1.0 - opt.shrinkage, inv = 1.0 / (double)(t - 1);
+    if (2 * t < n) {
+        double sy = 0;
+        for (size_t i = 0; i < n; i++) sy += colSum[i] * y[i];
+        fill(g, g + n, 0.0);
+        for (size_t k = 0; k < t; k++) {
+            const double* rk = &returns[k * n];
+            double z = 0;
+            for (size_t i = 0; i < n; i++) z += rk[i] * y[i];
+            for (size_t i = 0; i < n; i++) g[i] += z * rk[i];
+        }
+        for (size_t i = 0; i < n; i++)
+            g[i] = keepOff * (g[i] - colSum[i] * sy / (double)t) * inv + opt.shrinkage * cov[i * n + i] * y[i];
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            const double* row = &cov[i * n];
+            double sum = 0;
+            for (size_t j = 0; j < n; j++) sum += row[j] * y[j];
+            g[i] = keepOff * sum + opt.shrinkage * row[i] * y[i];
+        }
+    }
+}
+
+// The 1/L gradient step needs L ≥ λmax(Σ_s). The Gershgorin row-sum bound
+// always is one; a few power iterations usually give a far tighter value,
+// padded by 10% because they approach λmax from below.
+double Optimizer::gershgorin() const {
+    double bound = 0, keepOff = 1.0 - opt.shrinkage;
+    for (size_t i = 0; i < n; i++) bound = max(bound, keepOff * rowAbs[i] + cov[i * n + i]);
+    return bound;
+}
+
+void Optimizer::estimateLipschitz() {
+    double bound = gershgorin();
+    vector<double> v(n, 1.0 / sqrt((double)n)), u(n);
+    double est = 0;
+    for (int it = 0; it < 20; it++) {
+        multiply(v.data(), u.data());
+        double norm = 0;
+        for (double x : u) norm += x * x;
+        norm = sqrt(norm);
+        if (!(norm > 0)) break;
+        est = norm;
+        for (size_t i = 0; i < n; i++) v[i] = u[i] / norm;
+    }
+    lipschitz = min(bound, 1.1 * est);
+    if (!(lipschitz > 0)) lipschitz = max(bound, 1e-12);
+}
+
+size_t Optimizer::updatePrices(const vector<pair<string, double>>& latest) {
+    size_t changed = 0;
+    double growth = 0, inv = 1.0 / (double)(t - 1), invT = 1.0 / (double)t;
+    double* last = &returns[(t - 1) * n];
+    for (auto& p : latest) {
+        auto it = index.find(p.first);
+        if (it == index.end() || !(p.second > 0)) continue;
+        size_t i = it->second;
+        double rNew = p.second / prevPrice[i] - 1.0, rOld = last[i], d = rNew - rOld;
+        if (d == 0) continue;
+
+        // Only row/column i moves: Σ_ij changes by d·(r_tj − s_j/t)/(t − 1).
+        double moved = 0, total = 0;
+        for (size_t j = 0; j < n; j++) {
+            if (j == i) continue;
+            double old = cov[i * n + j], c = old + d * (last[j] - colSum[j] * invT) * inv;
+            rowAbs[j] += fabs(c) - fabs(old);
+            moved += 2 * (c - old) * (c - old);
+            cov[i * n + j] = c;
+            cov[j * n + i] = c;
+            total += fabs(c);
+        }
+        double crossII = cov[i * n + i] * (double)(t - 1) + colSum[i] * colSum[i] * invT
+                         + rNew * rNew - rOld * rOld;
+        colSum[i] += d;
+        last[i] = rNew;
+        double cii = (crossII - colSum[i] * colSum[i] * invT) * inv;
+        moved += (cii - cov[i * n + i]) * (cii - cov[i * n + i]);
+        cov[i * n + i] = cii;
+        rowAbs[i] = total;
+        mu[i] = colSum[i] * invT;
+        growth += sqrt(moved);
+        changed++;
+    }
+    // Weyl: λmax moves by at most ‖ΔΣ‖_F, so L stays a valid bound without
+    // another power iteration.
+    if (changed) lipschitz = min(lipschitz + growth, gershgorin());
+    return changed;
+}
+
+bool Optimizer::setSectorCap(const string& name, double cap) {
+    auto s = find(sectors.begin(), sectors.end(), name);
+    if (s == sectors.end()) {
+        cout << "Sector not found!\n";
+        return false;
+    }
+    double total = cap;
+    for (size_t k = 0; k < caps.size(); k++)
+        if ((int)k != s - sectors.begin()) total += caps[k];
+    if (cap < 0 || total < 1.0 - 1e-12) {
+        cout << "Error: Sector caps would add up to " << total << " < 1; cap not changed\n";
+        return false;
+    }
+    opt.sectorCaps[name] = cap;
+    caps[s - sectors.begin()] = cap;
+    return true;
+}
+
+/*===========================
+   Constraint Projection
+===========================*/
+// Euclidean projection onto {w ≥ 0, Σw = 1, Σ_{i∈s} w_i ≤ cap_s}. The
+// solution is w_i = max(v_i − τ − η_s, 0): bisection on the budget
+// multiplier τ, then on η_s inside every sector whose cap binds, each
+// finished with an exact solve on the active set it found.
+void Optimizer::project(const double* v, double* w) const {
+    size_t m = sectors.size();
+    vector<double> f(m);
+    vector<uint32_t> cand(n);
+    iota(cand.begin(), cand.end(), 0);
+
+    // Σ_s min(Σ_{i∈s} max(v_i − τ, 0), cap_s) over the candidates, which
+    // are every asset that can still be above τ.
+    auto total = [&](double tau) {
+        fill(f.begin(), f.end(), 0.0);
+        for (uint32_t i : cand)
+            if (v[i] > tau) f[sector[i]] += v[i] - tau;
+        double sum = 0;
+        for (size_t s = 0; s < m; s++) sum += min(f[s], caps[s]);
+        return sum;
+    };
+
+    double lo = *min_element(v, v + n) - 1.0;    // total(lo) ≥ 1 since caps ≤ 1
+    double hi = *max_element(v, v + n);          // total(hi) = 0
+    for (int it = 0; it < 60 && hi - lo > 1e-15 * (1.0 + fabs(hi)); it++) {
+        double mid = 0.5 * (lo + hi);
+        if (total(mid) >= 1.0) {
+            lo = mid;
+            // Assets at or below τ stay at zero for the rest of the search.
+            cand.erase(remove_if(cand.begin(), cand.end(), [&](uint32_t i) { return v[i] <= lo; }), cand.end());
+        } else {
+            hi = mid;
+        }
+    }
+
+    // Exact τ given which sectors are capped and which assets are active.
+    double tau = lo;
+    total(tau);
+    vector<char> isCapped(m, 0);
+    double capped = 0, activeSum = 0;
+    size_t active = 0;
+    for (size_t s = 0; s < m; s++)
+        if (f[s] > caps[s]) { isCapped[s] = 1; capped += caps[s]; }
+    for (uint32_t i : cand)
+        if (!isCapped[sector[i]] && v[i] > tau) { activeSum += v[i]; active++; }
+    if (active) {
+        double exact = (activeSum - (1.0 - capped)) / (double)active;
+        if (exact >= lo - 1e-12 && exact <= hi + 1e-12) tau = exact;
+    }
+
+    // η_s for capped sectors: Σ_{i∈s} max(v_i − τ − η, 0) = cap_s, searched
+    // over the sector's assets above τ only.
+    vector<double> eta(m, 0.0);
+    vector<vector<uint32_t>> members(m);
+    for (uint32_t i : cand)
+        if (isCapped[sector[i]] && v[i] > tau) members[sector[i]].push_back(i);
+    for (size_t s = 0; s < m; s++) {
+        if (!isCapped[s] || members[s].empty()) continue;
+        double elo = 0, ehi = 0, asum = 0;
+        size_t acnt = 0;
+        for (uint32_t i : members[s]) ehi = max(ehi, v[i] - tau);
+        auto sum = [&](double e) {
+            double out = 0;
+            asum = 0; acnt = 0;
+            for (uint32_t i : members[s])
+                if (v[i] - tau > e) { out += v[i] - tau - e; asum += v[i] - tau; acnt++; }
+            return out;
+        };
+        for (int it = 0; it < 60 && ehi - elo > 1e-15 * (1.0 + ehi); it++) {
+            double mid = 0.5 * (elo + ehi);
+            (sum(mid) > caps[s] ? elo : ehi) = mid;
+        }
+        sum(elo);
+        eta[s] = acnt ? max(0.0, (asum - caps[s]) / (double)acnt) : elo;
+    }
+
+    fill(w, w + n, 0.0);
+    for (uint32_t i : cand) w[i] = max(v[i] - tau - eta[sector[i]], 0.0);
+}
+
+/*===========================
+   Batched FISTA Solver
+===========================*/
+constexpr size_t COL_BLOCK = 512;     // output columns per gradient job
+
+Portfolio Optimizer::evaluate(const vector<double>& w, double lambda) const {
+    Portfolio p;
+    p.weights = w;
+    p.lambda = lambda;
+    vector<size_t> support;
+    for (size_t i = 0; i < n; i++)
+        if (w[i] != 0) { support.push_back(i); p.expectedReturn += mu[i] * w[i]; }
+    double var = 0, diag = 0;
+    for (size_t i : support) {
+        double row = 0;
+        for (size_t j : support) row += cov[i * n + j] * w[j];
+        var += w[i] * row;
+        diag += cov[i * n + i] * w[i] * w[i];
+    }
+    var = (1.0 - opt.shrinkage) * var + opt.shrinkage * diag;
+    p.volatility = sqrt(max(var, 0.0));
+    p.sharpe = p.volatility > 0 ? (p.expectedReturn - opt.riskFree) / p.volatility : 0.0;
+    return p;
+}
+
+vector<Portfolio> Optimizer::solve(const vector<double>& lambdas, vector<vector<double>>& w) {
+    size_t K = lambdas.size();
+    unsigned threads = threadCount(opt.threads);
+    w.resize(K);
+
+    vector<vector<double>> x(K), y(K), xn(K), g(K);
+    vector<double> tk(K, 1.0);
+    vector<int> iters(K, 0);
+    vector<char> done(K, 0);
+    vector<double> equal(n, 1.0 / (double)n);
+    for (size_t p = 0; p < K; p++) {
+        x[p].resize(n);
+        if (w[p].size() == n) project(w[p].data(), x[p].data());
+        else project(equal.data(), x[p].data());
+        y[p] = x[p];
+        xn[p].resize(n);
+        g[p].resize(n);
+    }
+
+    double step = 1.0 / lipschitz;
+    vector<size_t> act;
+    vector<uint32_t> support;
+    for (int it = 0; it < opt.maxIterations; it++) {
+        act.clear();
+        for (size_t p = 0; p < K; p++)
+            if (!done[p]) act.push_back(p);
+        if (act.empty()) break;
+
+        // g_p = Σ y_p. Long-only iterates are sparse, so Σ is read only on the
+        // rows in the union support, once per pass for every active point.
+        // Dense iterates (the first steps of a cold start) use multiply().
+        support.clear();
+        for (size_t j = 0; j < n; j++)
+            for (size_t p : act)
+                if (y[p][j] != 0) { support.push_back((uint32_t)j); break; }
+
+        if (support.size() > 2 * t) {
+            parallelFor(act.size(), act.size() > 1 ? threads : 1,
+                        [&](size_t q) { multiply(y[act[q]].data(), g[act[q]].data()); });
+        } else {
+            double keepOff = 1.0 - opt.shrinkage;
+            double work = (double)support.size() * n * act.size();
+            size_t blocks = (n + COL_BLOCK - 1) / COL_BLOCK;
+            parallelFor(blocks, work > 4e6 ? threads : 1, [&](size_t b) {
+                size_t c0 = b * COL_BLOCK, c1 = min(n, c0 + COL_BLOCK);
+                for (size_t p : act) fill(g[p].begin() + c0, g[p].begin() + c1, 0.0);
+                for (uint32_t j : support) {
+                    const double* row = &cov[(size_t)j * n];
+                    for (size_t p : act) {
+                        double a = y[p][j];
+                        if (a == 0) continue;
+                        double* gp = g[p].data();
+                        for (size_t c = c0; c < c1; c++) gp[c] += a * row[c];
+                    }
+                }
+                for (size_t p : act)
+                    for (size_t c = c0; c < c1; c++)
+                        g[p][c] = keepOff * g[p][c] + opt.shrinkage * cov[c * n + c] * y[p][c];
+            });
+        }
+
+        parallelFor(act.size(), act.size() > 1 && n >= 256 ? threads : 1, [&](size_t q) {
+            size_t p = act[q];
+            double lam = lambdas[p];
+            vector<double>& v = g[p];                       // reuse as the step point
+            for (size_t i = 0; i < n; i++) v[i] = y[p][i] - step * (v[i] - lam * mu[i]);
+            project(v.data(), xn[p].data());
+
+            double diff = 0, restart = 0;
+            for (size_t i = 0; i < n; i++) {
+                double dx = xn[p][i] - x[p][i];
+                diff = max(diff, fabs(dx));
+                restart += (y[p][i] - xn[p][i]) * dx;
+            }
+
+            // Adaptive restart drops the momentum when it points uphill.
+            if (restart > 0) {
+                tk[p] = 1.0;
+                y[p] = xn[p];
+            } else {
+                double tn = 0.5 * (1.0 + sqrt(1.0 + 4.0 * tk[p] * tk[p]));
+                double beta = (tk[p] - 1.0) / tn;
+                for (size_t i = 0; i < n; i++) y[p][i] = xn[p][i] + beta * (xn[p][i] - x[p][i]);
+                tk[p] = tn;
+            }
+            swap(x[p], xn[p]);
+            iters[p]++;
+            if (diff < opt.tolerance) done[p] = 1;
+        });
+    }
+
+    static const HotStats::Counter iterCount = HotStats::counter(
+        "investedge_optimizer_iterations_total", "", "Projected-gradient iterations run by the optimizer.");
+    vector<Portfolio> out(K);
+    for (size_t p = 0; p < K; p++) {
+        w[p] = x[p];
+        out[p] = evaluate(x[p], lambdas[p]);
+        out[p].iterations = iters[p];
+        out[p].converged = done[p];
+        iterCount.inc(iters[p]);
+    }
+    return out;
+}
+
+/*===========================
+   Problems
+===========================*/
+// λ that trades one unit of gradient-step curvature against the largest
+// expected return; the grid spans several decades around it.
+double Optimizer::lambdaScale() const {
+    double m = 0;
+    for (double v : mu) m = max(m, fabs(v));
+    return lipschitz / max(m, 1e-12);
+}
+
+vector<double> Optimizer::lambdaGrid(int points) const {
+    vector<double> grid(max(points, 2), 0.0);
+    double s = lambdaScale();
+    for (size_t k = 1; k < grid.size(); k++)
+        grid[k] = s * pow(10.0, -3.0 + 4.0 * (double)(k - 1) / (double)(grid.size() - 2));
+    return grid;
+}
+
+// `count` values strictly inside (lo, hi), evenly spaced in log λ.
+static vector<double> interior(double lo, double hi, int count) {
+    vector<double> out(max(count, 0));
+    for (int k = 0; k < count; k++) out[k] = lo * pow(hi / lo, (double)(k + 1) / (double)(count + 1));
+    return out;
+}
+
+// λ probed per refinement round: one per thread, so a round costs about one
+// solve of wall time; bisection on a single core.
+int Optimizer::refinePoints() const {
+    return (int)min(8u, threadCount(opt.threads));
+}
+
+double Optimizer::maxReturn() const {
+    // Linear objective: best asset of each sector, filled up to the cap in
+    // order of return.
+    vector<double> best(sectors.size(), -INFINITY);
+    for (size_t i = 0; i < n; i++) best[sector[i]] = max(best[sector[i]], mu[i]);
+    vector<size_t> order(sectors.size());
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](size_t a, size_t b) { return best[a] > best[b]; });
+    double left = 1.0, ret = 0;
+    for (size_t s : order) {
+        double take = min(left, caps[s]);
+        ret += take * best[s];
+        left -= take;
+        if (left <= 0) break;
+    }
+    return ret;
+}
+
+Portfolio Optimizer::minVariance() {
+    static const HotStats::Histogram solveTime = HotStats::histogram(
+        "investedge_optimizer_seconds", "phase=\"min_variance\"", "Portfolio optimizer time by phase.");
+    HotStats::ScopedTimer timer(solveTime);
+
+    vector<vector<double>> w = {warmMinVar};
+    Portfolio p = solve({0.0}, w)[0];
+    warmMinVar = w[0];
+    return p;
+}
+
+Portfolio Optimizer::maxSharpe() {
+    static const HotStats::Histogram solveTime = HotStats::histogram(
+        "investedge_optimizer_seconds", "phase=\"max_sharpe\"", "Portfolio optimizer time by phase.");
+    HotStats::ScopedTimer timer(solveTime);
+
+    // Bracket the best Sharpe ratio on a coarse batch (or around the last
+    // optimum when warm), then shrink the bracket around the best point.
+    vector<double> grid;
+    vector<vector<double>> w;
+    if (sharpeLambda > 0 && warmSharpe.size() == n) {
+        grid = {sharpeLambda / 1.5, sharpeLambda, sharpeLambda * 1.5};
+        w.assign(grid.size(), warmSharpe);
+    } else {
+        grid = lambdaGrid(12);
+    }
+    vector<Portfolio> pts = solve(grid, w);
+    int iterations = 0;
+    size_t b = 0;
+    for (size_t k = 0; k < pts.size(); k++) {
+        iterations += pts[k].iterations;
+        if (pts[k].sharpe > pts[b].sharpe) b = k;
+    }
+    Portfolio best = pts[b];
+    vector<double> bestW = w[b];
+    double hi = b + 1 < grid.size() ? grid[b + 1] : grid[b] * 10;
+    double lo = b > 0 && grid[b - 1] > 0 ? grid[b - 1] : hi / 1000;
+    if (best.lambda <= lo) best.lambda = lo * 1.0001;     // λ = 0 point: probe from just above
+
+    int k = refinePoints();
+    for (int round = 0; round < 40 && log(hi / lo) > 0.05; round++) {
+        // Probe both sides of the best point (the wider side when only one).
+        double left = log(best.lambda / lo), right = log(hi / best.lambda);
+        int nLeft = k == 1 ? (left > right ? 1 : 0) : k / 2;
+        grid = interior(lo, best.lambda, nLeft);
+        vector<double> more = interior(best.lambda, hi, k - nLeft);
+        grid.insert(grid.end(), more.begin(), more.end());
+        w.assign(grid.size(), bestW);
+        pts = solve(grid, w);
+
+        // New bracket: the neighbours of the best of {probes, best}.
+        vector<double> lams = {lo, hi, best.lambda};
+        size_t winner = grid.size();
+        for (size_t q = 0; q < pts.size(); q++) {
+            iterations += pts[q].iterations;
+            lams.push_back(grid[q]);
+            if (pts[q].sharpe > (winner < grid.size() ? pts[winner].sharpe : best.sharpe)) winner = q;
+        }
+        if (winner < grid.size()) {
+            best = pts[winner];
+            bestW = w[winner];
+        }
+        sort(lams.begin(), lams.end());
+        size_t at = lower_bound(lams.begin(), lams.end(), best.lambda) - lams.begin();
+        lo = lams[at - 1];
+        hi = lams[at + 1];
+    }
+    best.iterations = iterations;
+    sharpeLambda = best.lambda;
+    warmSharpe = bestW;
+    return best;
+}
+
+Portfolio Optimizer::targetReturn(double target) {
+    static const HotStats::Histogram solveTime = HotStats::histogram(
+        "investedge_optimizer_seconds", "phase=\"target_return\"", "Portfolio optimizer time by phase.");
+    HotStats::ScopedTimer timer(solveTime);
+
+    Portfolio floor = minVariance();
+    if (floor.expectedReturn >= target) return floor;
+    if (target > maxReturn()) {
+        cout << "Target return is above the best reachable " << maxReturn() << " per period\n";
+        return Portfolio{};
+    }
+
+    // Return grows with λ: bracket the target on a coarse batch, then shrink
+    // the bracket, keeping the smallest λ that reaches it.
+    int iterations = floor.iterations;
+    vector<double> grid = lambdaGrid(12);
+    vector<vector<double>> w;
+    if (warmTarget.size() == n) w.assign(grid.size(), warmTarget);
+    vector<Portfolio> pts = solve(grid, w);
+    for (auto& p : pts) iterations += p.iterations;
+    size_t at = 0;
+    while (at < pts.size() && pts[at].expectedReturn < target) at++;
+    if (at == 0) {                              // the λ = 0 point already reaches it
+        pts[0].iterations = iterations;
+        warmTarget = pts[0].weights;
+        return pts[0];
+    }
+
+    double lo, hi;
+    Portfolio best;
+    vector<double> bestW;
+    if (at < pts.size()) {
+        best = pts[at];
+        bestW = w[at];
+        hi = grid[at];
+        lo = grid[at - 1];
+        // The grid starts at λ = 0; stand in a positive lower end, checked
+        // to miss the target so the bracket holds. If it reaches the target
+        // it becomes the new upper end and the search steps further down.
+        for (int it = 0; it < 10 && lo <= 0; it++) {
+            vector<vector<double>> one = {bestW};
+            Portfolio p = solve({hi / 1000}, one)[0];
+            iterations += p.iterations;
+            if (p.expectedReturn < target) {
+                lo = hi / 1000;
+            } else {
+                hi /= 1000;
+                best = p;
+                bestW = one[0];
+            }
+        }
+        if (lo <= 0) {                          // reached at every λ tried: smallest one wins
+            best.iterations = iterations;
+            warmTarget = best.weights;
+            return best;
+        }
+    } else {                                    // beyond the grid: widen upward
+        lo = hi = grid.back();
+        bestW = w.back();
+        for (int it = 0; it < 20 && best.weights.empty(); it++) {
+            lo = hi;
+            hi *= 10;
+            vector<vector<double>> one = {bestW};
+            Portfolio p = solve({hi}, one)[0];
+            iterations += p.iterations;
+            bestW = one[0];
+            if (p.expectedReturn >= target) best = p;
+        }
+        if (best.weights.empty()) {
+            cout << "Target return not reached\n";
+            return best;
+        }
+    }
+
+    int k = refinePoints();
+    for (int round = 0; round < 60 && best.expectedReturn - target > 1e-3 * fabs(target); round++) {
+        if (hi / lo < 1 + 1e-9) break;
+        grid = interior(lo, hi, k);
+        w.assign(grid.size(), bestW);
+        pts = solve(grid, w);
+        size_t q = 0;
+        for (auto& p : pts) iterations += p.iterations;
+        while (q < pts.size() && pts[q].expectedReturn < target) q++;
+        if (q > 0) lo = grid[q - 1];
+        if (q < pts.size()) {
+            hi = grid[q];
+            best = pts[q];
+            bestW = w[q];
+        }
+    }
+    best.iterations = iterations;
+    warmTarget = best.weights;
+    return best;
+}
+
+vector<Portfolio> Optimizer::frontier(int points) {
+    static const HotStats::Histogram solveTime = HotStats::histogram(
+        "investedge_optimizer_seconds", "phase=\"frontier\"", "Portfolio optimizer time by phase.");
+    HotStats::ScopedTimer timer(solveTime);
+
+    vector<double> grid = lambdaGrid(points);
+    if (warmFrontier.size() != grid.size()) warmFrontier.clear();
+    return solve(grid, warmFrontier);
+}
+
+/*===========================
+   Reports
+===========================*/
+void printPortfolio(const Optimizer& o, const Portfolio& p, const string& title, size_t top) {
+    if (p.weights.empty()) return;
+    double ppy = o.options().periodsPerYear;
+    vector<size_t> idx;
+    for (size_t i = 0; i < p.weights.size(); i++)
+        if (p.weights[i] > 1e-6) idx.push_back(i);
+    sort(idx.begin(), idx.end(), [&](size_t a, size_t b) { return p.weights[a] > p.weights[b]; });
+
+    cout << "\n" << title << "\n----------------------------------------\n";
+    cout << fixed << setprecision(2);
+    cout << "Expected Return : " << p.expectedReturn * ppy * 100 << "% / year\n";
+    cout << "Volatility      : " << p.volatility * sqrt(ppy) * 100 << "% / year\n";
+    cout << "Sharpe Ratio    : " << p.sharpe * sqrt(ppy) << "\n";
+    cout << "Holdings        : " << idx.size() << " of " << o.assets()
+         << " (" << p.iterations << " iterations" << (p.converged ? "" : ", not converged") << ")\n";
+
+    cout << "\nTop Holdings:\n";
+    for (size_t r = 0; r < min(top, idx.size()); r++) {
+        size_t i = idx[r];
+        cout << left << setw(10) << o.symbols()[i] << " | "
+             << setw(16) << o.sectorNames()[o.sectorOf(i)] << " | "
+             << right << setw(6) << p.weights[i] * 100 << "%\n";
+    }
+
+    vector<double> bySector(o.sectorNames().size(), 0.0);
+    for (size_t i : idx) bySector[o.sectorOf(i)] += p.weights[i];
+    cout << "\nSector Allocation:\n";
+    for (size_t s = 0; s < bySector.size(); s++)
+        if (bySector[s] > 1e-6)
+            cout << left << setw(16) << o.sectorNames()[s] << " | "
+                 << right << setw(6) << bySector[s] * 100 << "%\n";
+    cout << left;
+}
+
+void printFrontier(const Optimizer& o, const vector<Portfolio>& pts) {
+    double ppy = o.options().periodsPerYear;
+    cout << "\nEfficient Frontier (annualized)\n";
+    cout << "Point |   Return |      Vol | Sharpe | Holdings | Iterations\n";
+    cout << "-------------------------------------------------------------\n";
+    cout << fixed << setprecision(2) << right;
+    for (size_t k = 0; k < pts.size(); k++) {
+        size_t held = count_if(pts[k].weights.begin(), pts[k].weights.end(), [](double w) { return w > 1e-6; });
+        cout << setw(5) << k + 1 << " | "
+             << setw(7) << pts[k].expectedReturn * ppy * 100 << "% | "
+             << setw(7) << pts[k].volatility * sqrt(ppy) * 100 << "% | "
+             << setw(6) << pts[k].sharpe * sqrt(ppy) << " | "
+             << setw(8) << held << " | "
+             << setw(10) << pts[k].iterations << "\n";
+    }
+    cout << left;
+}
+
+bool saveWeightsCSV(const string& path, const Optimizer& o, const Portfolio& p) {
+    ofstream out(path);
+    if (!out.is_open()) {
+        cout << "Error: Could not write " << path << endl;
+        return false;
+    }
+    out << "symbol,sector,weight\n";
+    for (size_t i = 0; i < p.weights.size(); i++)
+        if (p.weights[i] > 1e-9)
+            out << o.symbols()[i] << "," << o.sectorNames()[o.sectorOf(i)] << "," << p.weights[i] << "\n";
+    return true;
+}
+
+/*===========================
+   Entry Points
+===========================*/
+namespace {
+
+struct Session {
+    string universe = "portfolio.csv";
+    string history = "price_history.csv";
+    Options opt;
+    Optimizer optimizer;
+};
+
+// Loads portfolio.csv for the sectors, then the price history.
+// A missing history is an error: synthetic prices are only written by the
+// `generate` command, never in place of real closes.
+bool load(Session& s) {
+    if (PortfolioAnalyzer::stocks.empty() && !PortfolioAnalyzer::loadCSV(s.universe)) return false;
+
+    unordered_map<string, string> sectorOf;
+    for (auto& st : PortfolioAnalyzer::stocks) sectorOf[st.symbol] = st.sector;
+
+    PriceHistory h;
+    if (!ifstream(s.history).good()) {
+        cout << "Error: " << s.history << " not found (run `portfolio_optimizer generate` "
+             << "for a synthetic history, or supply real closes)" << endl;
+        return false;
+    }
+    if (!loadPriceHistory(s.history, h)) return false;
+
+    auto t0 = chrono::steady_clock::now();
+    if (!s.optimizer.build(h, sectorOf, s.opt)) return false;
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    cout << "Covariance of " << s.optimizer.assets() << " assets over " << s.optimizer.periods()
+         << " returns built in " << fixed << setprecision(1) << ms << " ms\n";
+    return true;
+}
+
+template <typename Fn>
+auto timed(const Fn& fn) {
+    auto t0 = chrono::steady_clock::now();
+    auto r = fn();
+    cout << "\nSolved in " << fixed << setprecision(1)
+         << chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count() << " ms\n";
+    return r;
+}
+
+bool parseCaps(const string& list, Options& opt) {
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ',')) {
+        size_t colon = item.rfind(':');
+        if (colon == string::npos) return false;
+        opt.sectorCaps[item.substr(0, colon)] = stod(item.substr(colon + 1));
+    }
+    return true;
+}
+
+} // namespace
+
+void run(const vector<string>& args) {
+    if (args.empty()) {
+        run();
+        return;
+    }
+
+    Session s;
+    string cmd = args[0], weights, out;
+    int points = 20;
+    double target = 0.15;
+    size_t periods = 253;
+
+    for (size_t i = 1; i < args.size(); i++) {
+        const string& a = args[i];
+        size_t eq = a.find('=');
+        string key = a.substr(0, eq), val = eq == string::npos ? "" : a.substr(eq + 1);
+        if (key == "--universe") s.universe = val;
+        else if (key == "--history") s.history = val;
+        else if (key == "--cap") s.opt.defaultSectorCap = stod(val);
+        else if (key == "--sector-cap") { if (!parseCaps(val, s.opt)) { cout << "Bad --sector-cap " << val << "\n"; return; } }
+        else if (key == "--shrinkage") s.opt.shrinkage = stod(val);
+        else if (key == "--risk-free") s.opt.riskFree = stod(val) / s.opt.periodsPerYear;
+        else if (key == "--threads") s.opt.threads = (unsigned)stoul(val);
+        else if (key == "--points") points = stoi(val);
+        else if (key == "--return") target = stod(val);
+        else if (key == "--periods") periods = stoul(val);
+        else if (key == "--weights") weights = val;
+        else if (key == "--out") out = val;
+        else { cout << "Unknown option " << a << "\n"; return; }
+    }
+
+    if (cmd == "generate") {
+        if (!PortfolioAnalyzer::loadCSV(s.universe)) return;
+        vector<string> symbols, sectorNames;
+        vector<double> prices;
+        for (auto& st : PortfolioAnalyzer::stocks) {
+            symbols.push_back(st.symbol);
+            sectorNames.push_back(st.sector);
+            prices.push_back(st.price);
+        }
+        if (out.empty()) out = s.history;
+        if (savePriceHistory(out, generatePriceHistory(symbols, sectorNames, prices, periods)))
+            cout << "Wrote " << periods << " periods for " << symbols.size() << " stocks to " << out << "\n";
+        return;
+    }
+
+    if (cmd != "min-variance" && cmd != "max-sharpe" && cmd != "target" && cmd != "frontier") {
+        cout << "Usage:\n"
+             << "  portfolio_optimizer generate [--universe=portfolio.csv] [--out=price_history.csv] [--periods=253]\n"
+             << "  portfolio_optimizer min-variance|max-sharpe|frontier|target [options]\n"
+             << "    --universe=portfolio.csv --history=price_history.csv\n"
+             << "    --cap=0.3 (every sector)  --sector-cap=IT:0.2,Banking:0.25\n"
+             << "    --return=0.15 (target, annual)  --points=20 (frontier)  --risk-free=0.05 (annual)\n"
+             << "    --shrinkage=0.1  --threads=N  --weights=weights.csv\n";
+        return;
+    }
+    if (!load(s)) return;
+
+    Optimizer& o = s.optimizer;
+    if (cmd == "frontier") {
+        printFrontier(o, timed([&] { return o.frontier(points); }));
+        return;
+    }
+
+    Portfolio p;
+    string title;
+    if (cmd == "min-variance") { p = timed([&] { return o.minVariance(); }); title = "Minimum Variance Portfolio"; }
+    else if (cmd == "max-sharpe") { p = timed([&] { return o.maxSharpe(); }); title = "Max Sharpe Portfolio"; }
+    else {
+        p = timed([&] { return o.targetReturn(target / s.opt.periodsPerYear); });
+        title = "Target Return Portfolio";
+    }
+    printPortfolio(o, p, title);
+    if (!weights.empty() && !p.weights.empty() && saveWeightsCSV(weights, o, p))
+        cout << "Weights written to " << weights << "\n";
+}
+
+void run() {
+    Session s;
+    HotStats::startPeriodicDumpFromEnv();
+    if (!load(s)) {
+        if (PortfolioAnalyzer::stocks.empty()) cout << "Please create portfolio.csv first!\n";
+        return;
+    }
+    Optimizer& o = s.optimizer;
+
+    while (true) {
+        cout << "\n=========== Portfolio Optimizer ===========\n";
+        cout << "1. Minimum Variance\n";
+        cout << "2. Max Sharpe\n";
+        cout << "3. Target Return\n";
+        cout << "4. Efficient Frontier\n";
+        cout << "5. Set Sector Cap\n";
+        cout << "6. Update Latest Price\n";
+        cout << "7. Show Stats\n";
+        cout << "0. Exit\n";
+        cout << "-------------------------------------------\n";
+        cout << "Enter choice: ";
+
+        int ch;
+        if (!(cin >> ch) || ch == 0) break;
+
+        if (ch == 1) printPortfolio(o, timed([&] { return o.minVariance(); }), "Minimum Variance Portfolio");
+        else if (ch == 2) printPortfolio(o, timed([&] { return o.maxSharpe(); }), "Max Sharpe Portfolio");
+        else if (ch == 3) {
+            double pct;
+            cout << "Target annual return (%): ";
+            cin >> pct;
+            printPortfolio(o, timed([&] { return o.targetReturn(pct / 100.0 / s.opt.periodsPerYear); }),
+                           "Target Return Portfolio");
+        } else if (ch == 4) {
+            int k;
+            cout << "How many points? ";
+            cin >> k;
+            printFrontier(o, timed([&] { return o.frontier(k); }));
+        } else if (ch == 5) {
+            string name;
+            double pct;
+            cout << "Sector: ";
+            cin >> name;
+            cout << "Max weight (%): ";
+            cin >> pct;
+            if (o.setSectorCap(name, pct / 100.0))
+                cout << "Cap for " << name << " set to " << pct << "%\n";
+        } else if (ch == 6) {
+            string sym;
+            double price;
+            cout << "Stock symbol: ";
+            cin >> sym;
+            cout << "Latest price: ";
+            cin >> price;
+            if (o.updatePrices({{sym, price}})) cout << "Covariance updated; next solve starts from the last weights.\n";
+            else cout << "Stock not found!\n";
+        } else if (ch == 7) HotStats::printStats(cout);
+        else cout << "Invalid choice! Try again.\n";
+    }
+}
+
+} // namespace PortfolioOptimizer
@@ -0,0 +1,147 @@
+// portfolio_optimizer.hpp
+// Mean-variance allocation for the portfolio.csv universe: covariance from a
+// price history, long-only + sector-cap constraints, minimum-variance,
+// max-Sharpe, target-return and efficient-frontier solves.
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PortfolioOptimizer {
+
+/*===========================
+   Price History
+===========================*/
+// CSV layout: date,SYM1,SYM2,... with one row per period, oldest first.
+struct PriceHistory {
+    std::vector<std::string> symbols;
+    std::vector<std::string> dates;
+    std::vector<double> prices;            // periods × assets, row-major
+
+    size_t periods() const { return dates.size(); }
+    size_t assets() const { return symbols.size(); }
+};
+
+bool loadPriceHistory(const std::string& path, PriceHistory& out);
+bool savePriceHistory(const std::string& path, const PriceHistory& h);
+
+// Synthetic one-factor-per-sector daily prices for `symbols`, starting at
+// `lastPrices` scaled back so the final row lands near them.
+PriceHistory generatePriceHistory(const std::vector<std::string>& symbols,
+                                  const std::vector<std::string>& sectors,
+                                  const std::vector<double>& lastPrices,
+                                  size_t periods, uint64_t seed = 42);
+
+/*===========================
+   Options & Results
+===========================*/
+struct Options {
+    double defaultSectorCap = 1.0;                        // max weight per sector
+    std::unordered_map<std::string, double> sectorCaps;   // per-sector overrides
+    double shrinkage = 0.1;         // 0..1, off-diagonal covariance shrink toward the diagonal
+    double riskFree = 0.0;          // per period
+    double periodsPerYear = 252;    // for annualized reporting
+    unsigned threads = 0;           // 0 = all cores
+    double tolerance = 1e-7;        // max weight change that counts as converged
+    int maxIterations = 5000;
+};
+
+struct Portfolio {
+    std::vector<double> weights;    // one per asset, sums to 1
+    double lambda = 0;              // return weight in ½wᵀΣw − λμᵀw
+    double expectedReturn = 0;      // per period
+    double volatility = 0;          // per period
+    double sharpe = 0;              // per period
+    int iterations = 0;             // solver iterations, summed over inner solves
+    bool converged = false;
+};
+
+/*===========================
+   Optimizer
+===========================*/
+class Optimizer {
+public:
+    Optimizer() = default;
+
+    // Builds returns and the covariance matrix. `sectorOf` maps symbols to
+    // sectors; symbols missing from it fall in "Unknown".
+    bool build(const PriceHistory& history,
+               const std::unordered_map<std::string, std::string>& sectorOf,
+               const Options& opt);
+
+    // Replaces the latest price of some assets and updates their covariance
+    // rows in O(assets) each; later solves warm-start from the last answer.
+    size_t updatePrices(const std::vector<std::pair<std::string, double>>& latest);
+
+    // Refuses caps that would leave no feasible portfolio.
+    bool setSectorCap(const std::string& sector, double cap);
+
+    Portfolio minVariance();
+    Portfolio maxSharpe();
+    Portfolio targetReturn(double perPeriodReturn);
+    std::vector<Portfolio> frontier(int points);
+
+    // Highest return reachable under the constraints (per period).
+    double maxReturn() const;
+
+    size_t assets() const { return n; }
+    size_t periods() const { return t; }
+    const std::vector<std::string>& symbols() const { return syms; }
+    const std::vector<std::string>& sectorNames() const { return sectors; }
+    int sectorOf(size_t asset) const { return sector[asset]; }
+    const std::vector<double>& mean() const { return mu; }
+    const std::vector<double>& covariance() const { return cov; }   // before shrinkage
+    const Options& options() const { return opt; }
+
+    // Solves ½wᵀΣw − λ_p μᵀw for every λ_p at once, sharing each pass over
+    // Σ. `w` holds one start point per λ on entry (empty = equal weight)
+    // and the solutions on return.
+    std::vector<Portfolio> solve(const std::vector<double>& lambdas,
+                                 std::vector<std::vector<double>>& w);
+
+private:
+    Options opt;
+    size_t n = 0, t = 0;                 // assets, return periods
+    std::vector<std::string> syms, sectors;
+    std::vector<int> sector;
+    std::unordered_map<std::string, size_t> index;
+    std::vector<double> caps;            // per sector
+    std::vector<double> returns;         // t × n, row-major
+    std::vector<double> prevPrice;       // price before the latest, per asset
+    std::vector<double> colSum;          // Σ_k r_ki
+    std::vector<double> cov, mu;         // sample covariance n × n, mean n
+    std::vector<double> rowAbs;          // Σ_{j≠i} |cov_ij|, for the step size
+    double lipschitz = 0;
+
+    std::vector<double> warmMinVar, warmSharpe, warmTarget;
+    double sharpeLambda = 0;
+    std::vector<std::vector<double>> warmFrontier;
+
+    void multiply(const double* y, double* g) const;
+    double gershgorin() const;
+    void estimateLipschitz();
+    double lambdaScale() const;
+    void project(const double* v, double* w) const;
+    Portfolio evaluate(const std::vector<double>& w, double lambda) const;
+    std::vector<double> lambdaGrid(int points) const;
+    int refinePoints() const;
+};
+
+// Blocked SYRK: cross = RᵀR for a t × n row-major R, upper triangle tiles
+// spread over `threads`, mirrored into the full matrix.
+void crossProducts(const double* r, size_t t, size_t n, double* cross, unsigned threads);
+
+/*===========================
+   Reports & Entry Points
+===========================*/
+void printPortfolio(const Optimizer& o, const Portfolio& p, const std::string& title, size_t top = 15);
+void printFrontier(const Optimizer& o, const std::vector<Portfolio>& pts);
+bool saveWeightsCSV(const std::string& path, const Optimizer& o, const Portfolio& p);
+
+void run(const std::vector<std::string>& args);   // CLI mode
+void run();                                        // interactive menu
+
+} // namespace PortfolioOptimizer
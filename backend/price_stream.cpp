@@ -0,0 +1,829 @@
+// price_stream.cpp
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <cctype>
+#include <cmath>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#ifdef INVESTEDGE_HAVE_OPENSSL
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#endif
+#include "price_stream.hpp"
+
+using namespace std;
+
+namespace PriceStream {
+
+constexpr size_t INITIAL_BUFFER = 1 << 16;
+constexpr uint64_t MAX_MESSAGE = 16u << 20;
+constexpr const char* WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+constexpr double REST_FAILURE_REPORT_SECONDS = 10;
+
+/*===========================
+   Handshake Helpers
+===========================*/
+static uint32_t rol(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+// SHA-1 is only used for the handshake accept key (RFC 6455 mandates it).
+static string sha1(const string& msg) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    string m = msg;
+    uint64_t bits = (uint64_t)msg.size() * 8;
+    m += (char)0x80;
+    while (m.size() % 64 != 56) m += (char)0;
+    for (int i = 7; i >= 0; i--) m += (char)(bits >> (i * 8));
+
+    for (size_t off = 0; off < m.size(); off += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++)
+            w[i] = (uint32_t)(unsigned char)m[off + 4 * i] << 24 |
+                   (uint32_t)(unsigned char)m[off + 4 * i + 1] << 16 |
+                   (uint32_t)(unsigned char)m[off + 4 * i + 2] << 8 |
+                   (uint32_t)(unsigned char)m[off + 4 * i + 3];
+        for (int i = 16; i < 80; i++) w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+            uint32_t t = rol(a, 5) + f + e + k + w[i];
+            e = d; d = c; c = rol(b, 30); b = a; a = t;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    string out;
+    for (uint32_t v : h)
+        for (int i = 3; i >= 0; i--) out += (char)(v >> (i * 8));
+    return out;
+}
+
+static string base64(const string& in) {
+    static const char* tbl = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    string out;
+    size_t i = 0;
+    for (; i + 2 < in.size(); i += 3) {
+        uint32_t v = (uint32_t)(unsigned char)in[i] << 16 | (uint32_t)(unsigned char)in[i + 1] << 8 |
+                     (unsigned char)in[i + 2];
+        out += tbl[v >> 18]; out += tbl[(v >> 12) & 63]; out += tbl[(v >> 6) & 63]; out += tbl[v & 63];
+    }
+    if (i + 1 == in.size()) {
+        uint32_t v = (uint32_t)(unsigned char)in[i] << 16;
+        out += tbl[v >> 18]; out += tbl[(v >> 12) & 63]; out += "==";
+    } else if (i + 2 == in.size()) {
+        uint32_t v = (uint32_t)(unsigned char)in[i] << 16 | (uint32_t)(unsigned char)in[i + 1] << 8;
+        out += tbl[v >> 18]; out += tbl[(v >> 12) & 63]; out += tbl[(v >> 6) & 63]; out += '=';
+    }
+    return out;
+}
+
+string websocketAccept(const string& key) {
+    return base64(sha1(key + WS_GUID));
+}
+
+bool parseUrl(const string& text, Url& out) {
+    size_t p;
+    if (text.rfind("ws://", 0) == 0) { out.tls = false; p = 5; }
+    else if (text.rfind("wss://", 0) == 0) { out.tls = true; p = 6; }
+    else return false;
+
+    size_t slash = text.find_first_of("/?", p);
+    string hostPort = text.substr(p, slash == string::npos ? string::npos : slash - p);
+    out.target = slash == string::npos ? "/" : text.substr(slash);
+    if (out.target[0] == '?') out.target = "/" + out.target;
+
+    size_t colon = hostPort.rfind(':');
+    out.host = hostPort.substr(0, colon);
+    out.port = colon == string::npos ? (out.tls ? "443" : "80") : hostPort.substr(colon + 1);
+    return !out.host.empty() && !out.port.empty();
+}
+
+static uint32_t maskKey() {
+    static thread_local mt19937 rng(random_device{}());
+    return rng();
+}
+
+void appendFrame(string& out, int opcode, string_view payload, bool mask) {
+    out += (char)(0x80 | opcode);
+    uint8_t m = mask ? 0x80 : 0;
+    size_t n = payload.size();
+    if (n < 126) {
+        out += (char)(m | n);
+    } else if (n <= 0xFFFF) {
+        out += (char)(m | 126);
+        out += (char)(n >> 8);
+        out += (char)n;
+    } else {
+        out += (char)(m | 127);
+        for (int i = 7; i >= 0; i--) out += (char)((uint64_t)n >> (i * 8));
+    }
+    if (!mask) {
+        out.append(payload.data(), n);
+        return;
+    }
+    uint32_t k = maskKey();
+    char key[4];
+    memcpy(key, &k, 4);
+    out.append(key, 4);
+    size_t at = out.size();
+    out.resize(at + n);
+    for (size_t i = 0; i < n; i++) out[at + i] = (char)(payload[i] ^ key[i & 3]);
+}
+
+/*===========================
+   WebSocket Client
+===========================*/
+struct WebSocket::Tls {
+#ifdef INVESTEDGE_HAVE_OPENSSL
+    SSL_CTX* ctx = nullptr;
+    SSL* ssl = nullptr;
+    ~Tls() {
+        if (ssl) SSL_free(ssl);
+        if (ctx) SSL_CTX_free(ctx);
+    }
+#endif
+};
+
+WebSocket::WebSocket() : buf(INITIAL_BUFFER) {}
+WebSocket::~WebSocket() { close(); }
+
+bool WebSocket::fail(const string& msg) {
+    lastError = msg;
+    close();
+    return false;
+}
+
+void WebSocket::close() {
+    tls.reset();
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    head = tail = 0;
+    fragments.clear();
+    fragmented = false;
+}
+
+long WebSocket::readSome(char* dst, size_t n) {
+#ifdef INVESTEDGE_HAVE_OPENSSL
+    if (tls) {
+        int r = SSL_read(tls->ssl, dst, (int)min<size_t>(n, 1 << 30));
+        return r > 0 ? r : (SSL_get_error(tls->ssl, r) == SSL_ERROR_ZERO_RETURN ? 0 : -1);
+    }
+#endif
+    ssize_t r;
+    do r = recv(fd, dst, n, 0); while (r < 0 && errno == EINTR);
+    return r;
+}
+
+bool WebSocket::writeAll(const char* src, size_t n) {
+    while (n > 0) {
+        long w;
+#ifdef INVESTEDGE_HAVE_OPENSSL
+        if (tls) w = SSL_write(tls->ssl, src, (int)min<size_t>(n, 1 << 30));
+        else
+#endif
+        w = send(fd, src, n, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return fail("write failed");
+        src += w;
+        n -= (size_t)w;
+    }
+    return true;
+}
+
+static bool waitFor(int fd, short events, int timeoutMs) {
+    pollfd p{fd, events, 0};
+    int r;
+    do r = ::poll(&p, 1, timeoutMs); while (r < 0 && errno == EINTR);
+    return r > 0;
+}
+
+static bool headerEquals(const string& headers, const string& name, const string& value) {
+    string lower = headers;
+    for (char& c : lower) c = (char)tolower((unsigned char)c);
+    size_t at = lower.find("\r\n" + name + ":");
+    if (at == string::npos) return false;
+    size_t v = at + name.size() + 3, end = headers.find("\r\n", v);
+    string got = headers.substr(v, end - v);
+    got.erase(0, got.find_first_not_of(" \t"));
+    got.erase(got.find_last_not_of(" \t") + 1);
+    return got == value;
+}
+
+bool WebSocket::connect(const Url& url, int timeoutMs) {
+    close();
+    lastError.clear();
+
+    addrinfo hints{}, *res = nullptr;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(url.host.c_str(), url.port.c_str(), &hints, &res) != 0)
+        return fail("cannot resolve " + url.host);
+
+    for (addrinfo* a = res; a && fd < 0; a = a->ai_next) {
+        int s = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (s < 0) continue;
+        // Non-blocking connect so an unreachable host times out promptly.
+        int flags = fcntl(s, F_GETFL, 0);
+        fcntl(s, F_SETFL, flags | O_NONBLOCK);
+        int r = ::connect(s, a->ai_addr, a->ai_addrlen);
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (r != 0 && !(errno == EINPROGRESS && waitFor(s, POLLOUT, timeoutMs) &&
+                        getsockopt(s, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0)) {
+            ::close(s);
+            continue;
+        }
+        fcntl(s, F_SETFL, flags);
+        // Blocking from here on, so bound each read and write: a peer that
+        // goes quiet mid-handshake or mid-frame cannot stall the stream thread.
+        timeval tv{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+        setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        int one = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fd = s;
+    }
+    freeaddrinfo(res);
+    if (fd < 0) return fail("cannot connect to " + url.host + ":" + url.port);
+
+    if (url.tls) {
+#ifdef INVESTEDGE_HAVE_OPENSSL
+        tls.reset(new Tls);
+        tls->ctx = SSL_CTX_new(TLS_client_method());
+        if (!tls->ctx) return fail("TLS context failed");
+        SSL_CTX_set_default_verify_paths(tls->ctx);
+        SSL_CTX_set_verify(tls->ctx, SSL_VERIFY_PEER, nullptr);
+        tls->ssl = SSL_new(tls->ctx);
+        SSL_set_fd(tls->ssl, fd);
+        SSL_set_tlsext_host_name(tls->ssl, url.host.c_str());
+        SSL_set1_host(tls->ssl, url.host.c_str());
+        if (SSL_connect(tls->ssl) != 1) return fail("TLS handshake with " + url.host + " failed");
+#else
+        return fail("wss:// needs a build with OpenSSL");
+#endif
+    }
+
+    string nonce(16, '\0');
+    for (size_t i = 0; i < nonce.size(); i += 4) {
+        uint32_t r = maskKey();
+        memcpy(&nonce[i], &r, 4);
+    }
+    string key = base64(nonce);
+    bool defaultPort = url.port == (url.tls ? "443" : "80");
+    string req = "GET " + url.target + " HTTP/1.1\r\n"
+                 "Host: " + url.host + (defaultPort ? "" : ":" + url.port) + "\r\n"
+                 "Upgrade: websocket\r\n"
+                 "Connection: Upgrade\r\n"
+                 "Sec-WebSocket-Key: " + key + "\r\n"
+                 "Sec-WebSocket-Version: 13\r\n"
+                 "User-Agent: InvestEdge\r\n\r\n";
+    if (!writeAll(req.data(), req.size())) return false;
+
+    // Frames may follow the 101 response in the same read; they stay in buf.
+    size_t end;
+    while ((end = string_view(buf.data(), tail).find("\r\n\r\n")) == string_view::npos) {
+        if (tail == buf.size()) return fail("handshake response too large");
+        bool ready = false;
+#ifdef INVESTEDGE_HAVE_OPENSSL
+        ready = tls && SSL_pending(tls->ssl) > 0;
+#endif
+        if (!ready && !waitFor(fd, POLLIN, timeoutMs)) return fail("handshake timed out");
+        long n = readSome(buf.data() + tail, buf.size() - tail);
+        if (n <= 0) return fail("connection closed during handshake");
+        tail += (size_t)n;
+    }
+    string headers(buf.data(), end + 2);
+    if (headers.compare(0, 12, "HTTP/1.1 101") != 0)
+        return fail("upgrade refused: " + headers.substr(0, headers.find("\r\n")));
+    if (!headerEquals(headers, "sec-websocket-accept", websocketAccept(key)))
+        return fail("bad Sec-WebSocket-Accept");
+    head = end + 4;
+    return true;
+}
+
+bool WebSocket::sendFrame(int opcode, string_view payload) {
+    if (fd < 0) return false;
+    string frame;
+    appendFrame(frame, opcode, payload, true);
+    return writeAll(frame.data(), frame.size());
+}
+
+bool WebSocket::sendText(string_view payload) {
+    return sendFrame(OP_TEXT, payload);
+}
+
+bool WebSocket::dispatch(const MessageHandler& onMessage) {
+    while (tail - head >= 2) {
+        unsigned char* p = (unsigned char*)buf.data() + head;
+        size_t avail = tail - head, hdr = 2;
+        bool fin = p[0] & 0x80, masked = p[1] & 0x80;
+        int op = p[0] & 0x0F;
+        uint64_t len = p[1] & 0x7F;
+        if (len == 126) {
+            if (avail < 4) break;
+            len = (uint64_t)p[2] << 8 | p[3];
+            hdr = 4;
+        } else if (len == 127) {
+            if (avail < 10) break;
+            len = 0;
+            for (int i = 0; i < 8; i++) len = len << 8 | p[2 + i];
+            hdr = 10;
+        }
+        if (len > MAX_MESSAGE) return fail("frame too large");
+        // RFC 6455 5.1, 5.2, 5.5: servers never mask, no extension was
+        // negotiated, and control frames are unfragmented and short.
+        if (masked) return fail("masked frame from server");
+        if (p[0] & 0x70) return fail("reserved frame bits set");
+        if ((op & 0x08) && (!fin || len > 125)) return fail("fragmented or oversized control frame");
+
+        if (avail < hdr + len) {
+            // Incomplete: make sure the whole frame will fit, then read more.
+            if (hdr + len > buf.size() - head) {
+                memmove(buf.data(), buf.data() + head, avail);
+                head = 0;
+                tail = avail;
+                if (hdr + len > buf.size()) buf.resize(max(buf.size() * 2, (size_t)(hdr + len)));
+            }
+            break;
+        }
+
+        char* payload = buf.data() + head + hdr;
+        head += hdr + len;
+        string_view msg(payload, len);
+
+        switch (op) {
+        case OP_TEXT:
+        case OP_BINARY:
+            if (fragmented) return fail("new message before the fragmented one finished");
+            if (fin) onMessage(msg);
+            else {
+                fragments.assign(msg.data(), msg.size());
+                fragmented = true;
+            }
+            break;
+        case OP_CONTINUATION:
+            if (!fragmented) return fail("unexpected continuation frame");
+            fragments.append(msg.data(), msg.size());
+            if (fragments.size() > MAX_MESSAGE) return fail("message too large");
+            if (fin) {
+                onMessage(fragments);
+                fragments.clear();
+                fragmented = false;
+            }
+            break;
+        case OP_PING:
+            if (!sendFrame(OP_PONG, msg)) return false;
+            break;
+        case OP_PONG:
+            break;
+        case OP_CLOSE: {
+            int code = len >= 2 ? (unsigned char)payload[0] << 8 | (unsigned char)payload[1] : 1005;
+            sendFrame(OP_CLOSE, msg.substr(0, 2));
+            return fail("server closed the stream (code " + to_string(code) + ")");
+        }
+        default:
+            return fail("unknown opcode " + to_string(op));
+        }
+    }
+    if (head == tail) head = tail = 0;
+    return true;
+}
+
+bool WebSocket::poll(int timeoutMs, const MessageHandler& onMessage) {
+    if (fd < 0) return false;
+    if (!dispatch(onMessage)) return false;        // frames left by the handshake
+
+    auto pending = [this] {
+#ifdef INVESTEDGE_HAVE_OPENSSL
+        if (tls && SSL_pending(tls->ssl) > 0) return true;
+#endif
+        return false;
+    };
+    if (!pending() && !waitFor(fd, POLLIN, timeoutMs)) return true;
+
+    // Drain what is already there, but return now and then so the caller
+    // can send heartbeats under a continuous stream.
+    for (int rounds = 0; rounds < 64; rounds++) {
+        if (tail == buf.size()) {
+            if (head > 0) {
+                memmove(buf.data(), buf.data() + head, tail - head);
+                tail -= head;
+                head = 0;
+            } else {
+                buf.resize(buf.size() * 2);
+            }
+        }
+        long n = readSome(buf.data() + tail, buf.size() - tail);
+        if (n == 0) return fail("connection closed by server");
+        if (n < 0) return fail(string("read failed: ") + strerror(errno));
+        tail += (size_t)n;
+        if (!dispatch(onMessage)) return false;
+        if (!pending() && !waitFor(fd, POLLIN, 0)) break;
+    }
+    return true;
+}
+
+/*===========================
+   Price Events
+===========================*/
+// Raw value of "key": (quotes stripped for strings); empty if absent.
+// Only what price events need: no escapes, no nested lookups.
+static string_view valueOf(string_view msg, string_view key) {
+    for (size_t from = 0;;) {
+        size_t k = msg.find(key, from);
+        if (k == string_view::npos) return {};
+        size_t p = k + key.size();
+        while (p < msg.size() && isspace((unsigned char)msg[p])) p++;
+        if (p < msg.size() && msg[p] == ':') {
+            p++;
+            while (p < msg.size() && isspace((unsigned char)msg[p])) p++;
+            if (p < msg.size() && msg[p] == '"') {
+                size_t e = msg.find('"', p + 1);
+                return e == string_view::npos ? string_view() : msg.substr(p + 1, e - p - 1);
+            }
+            size_t e = p;
+            while (e < msg.size() && msg[e] != ',' && msg[e] != '}' && msg[e] != ']' &&
+                   !isspace((unsigned char)msg[e]))
+                e++;
+            return msg.substr(p, e - p);
+        }
+        from = k + 1;   // matched a value such as "event":"price", keep looking
+    }
+}
+
+template <typename T>
+static bool parseNumber(string_view s, T& out) {
+    return !s.empty() && from_chars(s.data(), s.data() + s.size(), out).ec == errc();
+}
+
+bool parsePriceEvent(string_view msg, PriceEvent& out) {
+    if (valueOf(msg, "\"event\"") != "price") return false;
+    out.symbol = valueOf(msg, "\"symbol\"");
+    if (out.symbol.empty() || !parseNumber(valueOf(msg, "\"price\""), out.price)) return false;
+    if (!parseNumber(valueOf(msg, "\"seq\""), out.seq)) out.seq = -1;
+    if (!parseNumber(valueOf(msg, "\"ts_ns\""), out.sentNanos)) out.sentNanos = 0;
+    return true;
+}
+
+/*===========================
+   Streamer
+===========================*/
+HotStats::Counter Streamer::eventCounter(const char* source) {
+    return HotStats::counter("investedge_stream_prices_total", string("source=\"") + source + "\"",
+                             "Prices applied to the trackers, from the stream or REST fallback.");
+}
+
+HotStats::Counter Streamer::restFailureCounter() {
+    return HotStats::counter("investedge_stream_rest_failures_total", "",
+                             "REST fallback/backfill requests that returned no price.");
+}
+
+HotStats::Counter Streamer::reconnectCounter() {
+    return HotStats::counter("investedge_stream_reconnects_total", "",
+                             "Times the price stream was re-established after a drop.");
+}
+
+HotStats::Counter Streamer::gapCounter() {
+    return HotStats::counter("investedge_stream_gaps_total", "",
+                             "Jumps in the feed sequence number.");
+}
+
+HotStats::Counter Streamer::missedCounter() {
+    return HotStats::counter("investedge_stream_missed_total", "",
+                             "Price events skipped over by sequence gaps.");
+}
+
+Streamer::Streamer(const Options& o) : opt(o) {
+    vector<string> unique;
+    for (const string& s : opt.symbols)
+        if (!s.empty() && find(unique.begin(), unique.end(), s) == unique.end()) unique.push_back(s);
+    opt.symbols = move(unique);
+    for (size_t i = 0; i < opt.symbols.size(); i++) {
+        trackers.emplace_back(new RealTimeTracker::RealTimePriceTracker(opt.window));
+        index[opt.symbols[i]] = i;
+    }
+
+    if (!opt.url.empty()) {
+        string full = opt.url;
+        if (!opt.apiKey.empty() && full.find("apikey=") == string::npos)
+            full += (full.find('?') == string::npos ? "?apikey=" : "&apikey=") + opt.apiKey;
+        haveUrl = parseUrl(full, url);
+        if (!haveUrl) cout << "Error: Bad stream URL " << opt.url << ", using REST polling\n";
+    }
+    if (!opt.restPrice) {
+        string key = opt.apiKey;
+        opt.restPrice = [key](const string& sym, string* error) {
+            return RealTimeTracker::getStockPrice(sym, key, error);
+        };
+    }
+    if (!opt.ring.empty() && !ring.open(opt.ring))
+        cerr << "Tick ring unavailable (in use by another tracker?), streaming to local readers disabled.\n";
+}
+
+RealTimeTracker::RealTimePriceTracker* Streamer::tracker(const string& symbol) {
+    auto it = index.find(symbol);
+    return it == index.end() ? nullptr : trackers[it->second].get();
+}
+
+bool Streamer::connectAndSubscribe() {
+    if (!ws.connect(url)) return false;
+    string list;
+    for (const string& s : opt.symbols) list += (list.empty() ? "" : ",") + s;
+    return ws.sendText("{\"action\":\"subscribe\",\"params\":{\"symbols\":\"" + list + "\"}}");
+}
+
+void Streamer::apply(size_t i, double price) {
+    RealTimeTracker::RealTimePriceTracker& t = *trackers[i];
+    t.addPrice(price);
+    if (!ring.isOpen() && !opt.verbose) return;
+
+    double mn, mx, avg;
+    t.getStats(mn, mx, avg);
+    if (ring.isOpen()) {
+        ring.publishTick(opt.symbols[i], price);
+        ring.publishStats(opt.symbols[i], price, mn, mx, avg);
+    }
+    if (opt.verbose) {
+        lock_guard<mutex> out(outputLock);
+        cout << fixed << setprecision(2) << opt.symbols[i] << " $" << price
+             << " | Min: $" << mn << " | Max: $" << mx << " | Avg: $" << avg << "\n";
+    }
+}
+
+void Streamer::onMessage(string_view msg) {
+    static const HotStats::Histogram latency = HotStats::histogram(
+        "investedge_stream_latency_seconds", "",
+        "Delay from the feed stamping a price event to the trackers holding it.");
+
+    PriceEvent ev;
+    if (!parsePriceEvent(msg, ev)) {
+        if (valueOf(msg, "\"event\"") == "subscribe-status" && valueOf(msg, "\"status\"") != "ok")
+            cerr << "Subscription problem: " << msg << "\n";
+        return;
+    }
+    auto it = index.find(ev.symbol);
+    if (it == index.end()) return;
+
+    if (ev.seq >= 0) {
+        if (lastSeq >= 0 && ev.seq > lastSeq + 1) {
+            gapCount.inc();
+            missedCount.inc((uint64_t)(ev.seq - lastSeq - 1));
+            gapPending = true;
+        }
+        lastSeq = ev.seq;                       // a lower seq means the feed restarted
+    }
+
+    apply(it->second, ev.price);
+    priceCount.inc();
+    if (ev.sentNanos > 0) latency.recordSince(ev.sentNanos);
+    if (opt.onPrice) opt.onPrice(ev, HotStats::nowNanos());
+}
+
+// One slice of a REST snapshot: fetches symbols from where the last slice
+// stopped for about restSliceSeconds. True once the snapshot is complete.
+bool Streamer::pollRest() {
+    auto until = chrono::steady_clock::now() + chrono::duration<double>(opt.restSliceSeconds);
+    while (restNext < opt.symbols.size() && !stopping.load()) {
+        size_t i = restNext++;
+        string error;
+        double price = opt.restPrice(opt.symbols[i], &error);
+        if (price > 0) {
+            apply(i, price);
+            restCount.inc();
+        } else {
+            restFailed(opt.symbols[i], error);
+        }
+        if (chrono::steady_clock::now() >= until) break;
+    }
+    if (restNext < opt.symbols.size()) return false;
+    restNext = 0;
+    return true;
+}
+
+// Every failure is counted; unless quiet, one line per REST_FAILURE_REPORT_SECONDS
+// reports the latest with how many were held back, so a dead API key or
+// network over a long symbol list does not flood the output.
+void Streamer::restFailed(const string& symbol, const string& error) {
+    restFailCount.inc();
+    unreportedFailures++;
+    int64_t now = HotStats::nowNanos();
+    if (!opt.verbose || now < nextFailureReport) return;
+    nextFailureReport = now + (int64_t)(REST_FAILURE_REPORT_SECONDS * 1e9);
+
+    lock_guard<mutex> out(outputLock);
+    cerr << "REST price for " << symbol << " failed: " << (error.empty() ? "no price returned" : error);
+    if (unreportedFailures > 1) cerr << " (" << unreportedFailures - 1 << " more since the last report)";
+    cerr << endl;
+    unreportedFailures = 0;
+}
+
+void Streamer::run() {
+    using Clock = chrono::steady_clock;
+    auto secs = [](double s) { return chrono::duration_cast<Clock::duration>(chrono::duration<double>(s)); };
+
+    auto start = Clock::now(), end = start + secs(opt.runSeconds);
+    auto nextAttempt = start, nextPoll = start, nextBeat = start, nextBackfill = start, lastTraffic = start;
+    double backoff = 0.5;
+    bool everConnected = false;
+
+    if (!haveUrl && opt.verbose)
+        cout << "No stream configured: polling REST every " << opt.pollSeconds << " s\n";
+
+    while (!stopping.load() && (opt.runSeconds <= 0 || Clock::now() < end)) {
+        auto now = Clock::now();
+        if (!ws.isOpen() && haveUrl && now >= nextAttempt) {
+            if (connectAndSubscribe()) {
+                connected = true;
+                if (opt.verbose) {
+                    lock_guard<mutex> out(outputLock);
+                    cout << (everConnected ? "Reconnected to " : "Streaming from ") << url.host
+                         << " (" << opt.symbols.size() << " symbols)" << endl;
+                }
+                if (everConnected) {
+                    reconnectCount.inc();
+                    // Whatever moved while we were away is not replayed by the
+                    // feed; the snapshot runs in slices between reads below.
+                    gapPending = opt.backfill;
+                    nextBackfill = now;
+                }
+                everConnected = true;
+                backoff = 0.5;
+                now = Clock::now();
+                lastTraffic = nextBeat = now;
+                nextBeat += secs(opt.heartbeatSeconds);
+            } else {
+                cerr << "Stream unavailable (" << ws.error() << "), retrying in " << backoff << " s\n";
+                nextAttempt = now + secs(backoff);
+                backoff = min(backoff * 2, opt.maxBackoffSeconds);
+            }
+        }
+
+        if (!ws.isOpen()) {
+            connected = false;
+            if (now >= nextPoll && pollRest()) nextPoll = Clock::now() + secs(opt.pollSeconds);
+            this_thread::sleep_for(chrono::milliseconds(50));
+            continue;
+        }
+
+        bool traffic = false;
+        if (!ws.poll(100, [&](string_view m) { traffic = true; onMessage(m); })) {
+            connected = false;
+            if (opt.verbose) cerr << "Stream lost (" << ws.error() << "), polling REST until it is back\n";
+            nextAttempt = nextPoll = Clock::now();
+            continue;
+        }
+
+        now = Clock::now();
+        if (traffic) lastTraffic = now;
+        if (gapPending && opt.backfill && now >= nextBackfill) {
+            gapPending = !pollRest();
+            if (!gapPending) nextBackfill = Clock::now() + secs(opt.pollSeconds);
+        }
+        if (now >= nextBeat) {
+            ws.sendText("{\"action\":\"heartbeat\"}");
+            nextBeat = now + secs(opt.heartbeatSeconds);
+        }
+        if (now - lastTraffic > secs(opt.staleSeconds)) {
+            if (opt.verbose) cerr << "No data for " << opt.staleSeconds << " s, reconnecting\n";
+            ws.close();
+            connected = false;
+            nextAttempt = now;
+        }
+    }
+    ws.close();
+    connected = false;
+}
+
+void Streamer::printSummary() {
+    cout << "\nStream Summary\n----------------------------------------\n";
+    cout << "Streamed prices : " << prices() << "\n";
+    cout << "REST prices     : " << restPrices() << " (" << restFailures() << " failed)\n";
+    cout << "Reconnects      : " << reconnects() << "\n";
+    cout << "Sequence gaps   : " << gaps() << " (" << missed() << " events missed)\n\n";
+    for (size_t i = 0; i < opt.symbols.size(); i++) {
+        double mn, mx, avg;
+        trackers[i]->getStats(mn, mx, avg);
+        cout << left << setw(10) << opt.symbols[i] << right;
+        if (isnan(avg)) cout << "no prices received\n";
+        else trackers[i]->printStats();
+    }
+}
+
+/*===========================
+   Entry Points
+===========================*/
+static string defaultStreamUrl() {
+    const char* env = getenv("TWELVEDATA_WS_URL");
+    return env && *env ? string(env) : "wss://ws.twelvedata.com/v1/quotes/price";
+}
+
+static vector<string> splitSymbols(const string& list) {
+    vector<string> out;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+// Streams until `exit` (or end of input) on stdin; `stats` prints timings.
+static void streamInteractive(Options opt) {
+    Streamer streamer(opt);
+    thread input([&streamer] {
+        string cmd;
+        while (cin >> cmd) {
+            if (cmd == "exit" || cmd == "EXIT") break;
+            if (cmd != "stats" && cmd != "STATS") continue;
+            ostringstream report;                 // printStats changes stream flags
+            HotStats::printStats(report);
+            lock_guard<mutex> out(streamer.output());
+            cout << report.str() << flush;
+        }
+        streamer.stop();
+    });
+    streamer.run();
+    input.join();
+    streamer.printSummary();
+}
+
+void run(const vector<string>& args) {
+    if (args.empty()) {
+        run();
+        return;
+    }
+
+    Options opt;
+    opt.url = defaultStreamUrl();
+    for (const string& a : args) {
+        size_t eq = a.find('=');
+        string key = a.substr(0, eq), val = eq == string::npos ? "" : a.substr(eq + 1);
+        if (key == "--symbols") opt.symbols = splitSymbols(val);
+        else if (key == "--url") opt.url = val;
+        else if (key == "--rest") opt.url.clear();
+        else if (key == "--apikey") opt.apiKey = val;
+        else if (key == "--seconds") opt.runSeconds = stod(val);
+        else if (key == "--poll") opt.pollSeconds = stod(val);
+        else if (key == "--window") opt.window = stoul(val);
+        else if (key == "--ring") opt.ring = val;
+        else if (key == "--no-backfill") opt.backfill = false;
+        else if (key == "--quiet") opt.verbose = false;
+        else { cout << "Unknown option " << a << "\n"; return; }
+    }
+    if (opt.symbols.empty()) {
+        cout << "Usage:\n"
+             << "  price_stream --symbols=AAPL,MSFT [--url=wss://ws.twelvedata.com/v1/quotes/price]\n"
+             << "               [--apikey=KEY] [--rest] [--seconds=N] [--poll=5] [--window=10]\n"
+             << "               [--ring=/investedge_price_stream] [--no-backfill] [--quiet]\n";
+        return;
+    }
+
+    HotStats::startPeriodicDumpFromEnv();
+    if (opt.runSeconds > 0) {
+        Streamer streamer(opt);
+        streamer.run();
+        streamer.printSummary();
+    } else {
+        cout << "Type 'exit' to stop, 'stats' for timings.\n";
+        streamInteractive(opt);
+    }
+}
+
+void run() {
+    Options opt;
+    opt.url = defaultStreamUrl();
+    HotStats::startPeriodicDumpFromEnv();
+
+    cout << "📡 Streaming Price Tracker\n";
+    cout << "Enter stock symbols separated by commas: ";
+    string list;
+    cin >> list;
+    opt.symbols = splitSymbols(list);
+    if (opt.symbols.empty()) return;
+
+    cout << "Type 'exit' to stop, 'stats' for timings.\n\n";
+    streamInteractive(opt);
+}
+
+} // namespace PriceStream
@@ -0,0 +1,190 @@
+// price_stream.hpp
+// Push-based price ingestion: one persistent WebSocket subscription (Twelve
+// Data /v1/quotes/price protocol) for the whole watched symbol set, decoded
+// straight into the rolling-window trackers and the tick ring. Frames are
+// parsed in place in the receive buffer and price events are read through
+// string_views, so the steady state copies nothing. When the stream is
+// down it reconnects with backoff, resubscribes, backfills over REST and
+// polls getStockPrice until the stream is back.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "hot_stats.hpp"
+#include "real_time_tracker.hpp"
+#include "tick_ring.hpp"
+
+namespace PriceStream {
+
+/*===========================
+   WebSocket Client
+===========================*/
+struct Url {
+    bool tls = false;
+    std::string host, port, target;    // target = path + query
+};
+
+// ws://host[:port]/path?query or wss://...; false if malformed.
+bool parseUrl(const std::string& text, Url& out);
+
+// Sec-WebSocket-Accept value for a Sec-WebSocket-Key (RFC 6455 §4.2.2).
+std::string websocketAccept(const std::string& key);
+
+// Builds one unfragmented frame; clients must mask (RFC 6455 §5.3).
+void appendFrame(std::string& out, int opcode, std::string_view payload, bool mask);
+
+enum Opcode { OP_CONTINUATION = 0, OP_TEXT = 1, OP_BINARY = 2, OP_CLOSE = 8, OP_PING = 9, OP_PONG = 10 };
+
+// Blocking socket, optionally TLS (when built with OpenSSL). Reads and
+// writes, the TLS handshake included, give up after the connect timeout.
+class WebSocket {
+public:
+    using MessageHandler = std::function<void(std::string_view)>;
+
+    WebSocket();
+    ~WebSocket();
+    WebSocket(const WebSocket&) = delete;
+    WebSocket& operator=(const WebSocket&) = delete;
+
+    // TCP connect, TLS handshake for wss://, then the HTTP upgrade.
+    bool connect(const Url& url, int timeoutMs = 5000);
+    bool sendText(std::string_view payload);
+
+    // Waits up to timeoutMs for data, then hands every complete text message
+    // to `onMessage` (valid only during the call) and answers pings. Returns
+    // false once the connection is closed or broken.
+    bool poll(int timeoutMs, const MessageHandler& onMessage);
+
+    void close();
+    bool isOpen() const { return fd >= 0; }
+    const std::string& error() const { return lastError; }
+
+private:
+    struct Tls;
+    int fd = -1;
+    std::unique_ptr<Tls> tls;
+    std::vector<char> buf;             // received bytes in [head, tail)
+    size_t head = 0, tail = 0;
+    std::string fragments;             // only for fragmented messages
+    bool fragmented = false;
+    std::string lastError;
+
+    long readSome(char* dst, size_t n);
+    bool writeAll(const char* src, size_t n);
+    bool sendFrame(int opcode, std::string_view payload);
+    bool fail(const std::string& msg);
+    bool dispatch(const MessageHandler& onMessage);   // parses buffered frames
+};
+
+/*===========================
+   Price Events
+===========================*/
+// {"event":"price","symbol":"AAPL",...,"timestamp":1592249566,"price":342.01}
+// `seq` (feed sequence number) and `ts_ns` (sender's steady clock) are
+// optional; the local stub sends both for gap detection and latency.
+struct PriceEvent {
+    std::string_view symbol;
+    double price = 0;
+    int64_t seq = -1;
+    int64_t sentNanos = 0;
+};
+
+// True for price events; `symbol` points into `msg`.
+bool parsePriceEvent(std::string_view msg, PriceEvent& out);
+
+/*===========================
+   Streamer
+===========================*/
+struct Options {
+    std::string url;                   // ws:// or wss://; empty = REST polling only
+    std::string apiKey = "YOUR_API_KEY";
+    std::vector<std::string> symbols;
+    size_t window = 10;                // tracker rolling window
+    double pollSeconds = 5;            // REST round interval while the stream is down
+    double heartbeatSeconds = 10;
+    double staleSeconds = 30;          // silence this long = dead connection
+    double maxBackoffSeconds = 30;
+    double runSeconds = 0;             // 0 = until stop()
+    bool backfill = true;              // REST snapshot after a reconnect or gap
+    double restSliceSeconds = 2;       // REST time per loop turn; a snapshot resumes next turn
+    bool verbose = true;               // print connection changes and prices
+    std::string ring = TickRing::defaultName("price_stream");   // empty = no tick ring
+
+    // REST price source for fallback and backfill (default getStockPrice).
+    // Returns <= 0 on failure, with the reason in *error when it has one.
+    std::function<double(const std::string&, std::string* error)> restPrice;
+    // Called for every price applied, with the local receive time.
+    std::function<void(const PriceEvent&, int64_t)> onPrice;
+};
+
+class Streamer {
+public:
+    explicit Streamer(const Options& opt);
+
+    void run();                        // blocks until runSeconds or stop()
+    void stop() { stopping.store(true); }
+
+    uint64_t prices() const { return priceCount.get(); }
+    uint64_t restPrices() const { return restCount.get(); }
+    uint64_t restFailures() const { return restFailCount.get(); }
+    uint64_t reconnects() const { return reconnectCount.get(); }
+    uint64_t gaps() const { return gapCount.get(); }
+    uint64_t missed() const { return missedCount.get(); }   // events lost in gaps
+    bool streaming() const { return connected.load(); }
+
+    RealTimeTracker::RealTimePriceTracker* tracker(const std::string& symbol);
+    void printSummary();
+    // Held while run() prints; hold it to write to stdout from another thread.
+    std::mutex& output() { return outputLock; }
+
+private:
+    Options opt;
+    Url url;
+    bool haveUrl = false;
+    WebSocket ws;
+    TickRing::Producer ring;
+    std::vector<std::unique_ptr<RealTimeTracker::RealTimePriceTracker>> trackers;
+    std::unordered_map<std::string_view, size_t> index;    // views into opt.symbols
+    int64_t lastSeq = -1;
+    bool gapPending = false;           // a backfill snapshot is due or under way
+    size_t restNext = 0;               // next symbol of the current REST snapshot
+    int64_t nextFailureReport = 0;     // HotStats::nowNanos() before which failures are only counted
+    uint64_t unreportedFailures = 0;
+    std::mutex outputLock;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> connected{false};
+
+    HotStats::LocalCounter priceCount{eventCounter("stream")};
+    HotStats::LocalCounter restCount{eventCounter("rest")};
+    HotStats::LocalCounter restFailCount{restFailureCounter()};
+    HotStats::LocalCounter reconnectCount{reconnectCounter()};
+    HotStats::LocalCounter gapCount{gapCounter()};
+    HotStats::LocalCounter missedCount{missedCounter()};
+
+    static HotStats::Counter eventCounter(const char* source);
+    static HotStats::Counter restFailureCounter();
+    static HotStats::Counter reconnectCounter();
+    static HotStats::Counter gapCounter();
+    static HotStats::Counter missedCounter();
+
+    bool connectAndSubscribe();
+    void onMessage(std::string_view msg);
+    void apply(size_t i, double price);
+    bool pollRest();
+    void restFailed(const std::string& symbol, const std::string& error);
+};
+
+/*===========================
+   Entry Points
+===========================*/
+void run(const std::vector<std::string>& args);   // CLI mode
+void run();                                        // interactive
+
+} // namespace PriceStream
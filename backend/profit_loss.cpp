@@ -4,24 +4,38 @@
 #include <iomanip>
 #include <fstream>
 #include <sstream>
+#include <limits>
+#include <cstring>
+#include <cctype>
+#include "profit_loss.hpp"
 using namespace std;
 
 
 namespace ProfitLossModule{
 
-    // ======== STRUCTURE ========
-    struct ProfitLoss {
-        string stockname;
-        string type;
-        int quantity;
-        double price;
-    };
-
     // ======== GLOBALS ========
     stack<ProfitLoss> profitlosshistory, redoStack;
     double totalInvestment = 0.0, totalProfitLoss = 0.0;
     const string Fhistory = "History.csv";
 
+    // ======== LEDGER ACCOUNTING ========
+    static bool sameType(const string& type, const char* want) {
+        if (type.size() != strlen(want)) return false;
+        for (size_t i = 0; i < type.size(); i++)
+            if (tolower((unsigned char)type[i]) != want[i]) return false;
+        return true;
+    }
+
+    bool isBuy(const string& type) { return sameType(type, "buy"); }
+    bool isSell(const string& type) { return sameType(type, "sell"); }
+
+    void applyTrade(const ProfitLoss& pl, double& investment, double& sellValue, int sign) {
+        if (isBuy(pl.type))
+            investment += sign * pl.quantity * pl.price;
+        else if (isSell(pl.type))
+            sellValue += sign * pl.quantity * pl.price;
+    }
+
     // ======== FILE HANDLING ========
     void savehistory() {
         ofstream file(Fhistory);
@@ -54,10 +68,7 @@ namespace ProfitLossModule{
             pl.quantity = stoi(qty);
             pl.price = stod(pr);
             profitlosshistory.push(pl);
-            if (pl.type == "BUY" || pl.type == "buy")
-                totalInvestment += pl.price * pl.quantity;
-            else if (pl.type == "SELL" || pl.type == "sell")
-                totalProfitLoss += pl.price * pl.quantity;
+            applyTrade(pl, totalInvestment, totalProfitLoss, +1);
         }
         file.close();
     }
@@ -77,10 +88,8 @@ namespace ProfitLossModule{
         profitlosshistory.push(pl);
         while (!redoStack.empty()) redoStack.pop();
 
-        if (pl.type == "Buy" || pl.type == "buy")
-            totalInvestment += pl.quantity * pl.price;
-        else if (pl.type == "Sell" || pl.type == "sell")
-            totalProfitLoss += pl.quantity * pl.price;
+        if (isBuy(pl.type) || isSell(pl.type))
+            applyTrade(pl, totalInvestment, totalProfitLoss, +1);
         else
             cout << "Invalid Trade Type\n";
 
@@ -96,10 +105,7 @@ namespace ProfitLossModule{
         profitlosshistory.pop();
         redoStack.push(last);
 
-        if (last.type == "Buy" || last.type == "buy")
-            totalInvestment -= last.quantity * last.price;
-        else if (last.type == "Sell" || last.type == "sell")
-            totalProfitLoss -= last.quantity * last.price;
+        applyTrade(last, totalInvestment, totalProfitLoss, -1);
 
         cout << "↩️ Undo successful\n";
     }
@@ -113,10 +119,7 @@ namespace ProfitLossModule{
         redoStack.pop();
         profitlosshistory.push(pl);
 
-        if (pl.type == "Buy" || pl.type == "buy")
-            totalInvestment += pl.quantity * pl.price;
-        else if (pl.type == "Sell" || pl.type == "sell")
-            totalProfitLoss += pl.quantity * pl.price;
+        applyTrade(pl, totalInvestment, totalProfitLoss, +1);
 
         cout << "↪️ Redo successful\n";
     }
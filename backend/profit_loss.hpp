@@ -0,0 +1,41 @@
+// profit_loss.hpp
+#pragma once
+
+#include <stack>
+#include <string>
+
+namespace ProfitLossModule {
+
+    // ======== STRUCTURE ========
+    struct ProfitLoss {
+        std::string stockname;
+        std::string type;
+        int quantity;
+        double price;
+    };
+
+    // ======== GLOBALS ========
+    extern std::stack<ProfitLoss> profitlosshistory, redoStack;
+    extern double totalInvestment, totalProfitLoss;
+    extern const std::string Fhistory;
+
+    // ======== LEDGER ACCOUNTING ========
+    // Trade types are matched case-insensitively ("Buy", "BUY", "buy").
+    bool isBuy(const std::string& type);
+    bool isSell(const std::string& type);
+    // Adds (sign = +1) or removes (sign = -1) a trade from the running totals.
+    void applyTrade(const ProfitLoss& pl, double& investment, double& sellValue, int sign = +1);
+
+    // ======== FILE HANDLING ========
+    void savehistory();
+    void LoadHistory();
+
+    // ======== TRADING SYSTEM ========
+    void TradeStock();
+    void undo();
+    void redo();
+    void DisplaySummary();
+    void DisplayHistory();
+    void run();
+
+} // namespace ProfitLossModule
@@ -1,59 +1,20 @@
 #include <iostream>
 #include <iomanip>
 #include <string>
-#include <deque>
-#include <set>
-#include <mutex>
+#include <cstdlib>
 #include <thread>
 #include <chrono>
 #include <curl/curl.h>
 #include "json.hpp" // Download from: https://github.com/nlohmann/json
+#include "tick_ring.hpp"
+#include "real_time_tracker.hpp"
+#include "hot_stats.hpp"
 
 using json = nlohmann::json;
 using namespace std;
 
 namespace RealTimeTracker {
 
-    // ---------------------- Real-Time Tracker Class ----------------------
-    class RealTimePriceTracker {
-    private:
-        deque<double> window;
-        multiset<double> bst;
-        size_t window_size;
-        double sum;
-        mutex mtx;
-
-    public:
-        RealTimePriceTracker(size_t n = 10) : window_size(n), sum(0.0) {}
-
-        void addPrice(double price) {
-            lock_guard<mutex> lock(mtx);
-            window.push_back(price);
-            bst.insert(price);
-            sum += price;
-
-            if (window.size() > window_size) {
-                double old = window.front();
-                window.pop_front();
-                bst.erase(bst.find(old));
-                sum -= old;
-            }
-        }
-
-        void printStats() {
-            lock_guard<mutex> lock(mtx);
-            cout << fixed << setprecision(2);
-
-            double min = bst.empty() ? NAN : *bst.begin();
-            double max = bst.empty() ? NAN : *bst.rbegin();
-            double avg = window.empty() ? NAN : sum / window.size();
-
-            cout << "Min: $" << min
-                 << " | Max: $" << max
-                 << " | Avg: $" << avg << "\n";
-        }
-    };
-
     // ---------------------- CURL JSON Fetching ----------------------
     size_t WriteCallback(void* contents, size_t size, size_t nmemb, string* output) {
         size_t totalSize = size * nmemb;
@@ -61,33 +22,63 @@ namespace RealTimeTracker {
         return totalSize;
     }
 
-    double getStockPrice(const string& symbol, const string& apiKey) {
+    // Overridable with TWELVEDATA_BASE_URL (e.g. a local stub server).
+    string apiBaseUrl() {
+        const char* env = getenv("TWELVEDATA_BASE_URL");
+        return env && *env ? string(env) : "https://api.twelvedata.com";
+    }
+
+    double parsePriceResponse(const string& body, string* error) {
+        try {
+            auto j = json::parse(body);
+            if (j.contains("price")) {
+                return stod(j["price"].get<string>());
+            } else if (error) {
+                *error = "API error: " + j.dump();
+            }
+        } catch (exception& e) {
+            if (error) *error = string("JSON parse error: ") + e.what();
+        }
+        return -1.0;
+    }
+
+    double getStockPrice(const string& symbol, const string& apiKey, string* error) {
+        static const HotStats::Histogram curlTime = HotStats::histogram(
+            "investedge_price_fetch_seconds", "module=\"real_time_tracker\",phase=\"curl\"",
+            "Time spent in getStockPrice, split into HTTP transfer and JSON parsing.");
+        static const HotStats::Histogram parseTime = HotStats::histogram(
+            "investedge_price_fetch_seconds", "module=\"real_time_tracker\",phase=\"parse\"",
+            "Time spent in getStockPrice, split into HTTP transfer and JSON parsing.");
+
         CURL* curl;
-        CURLcode res;
+        CURLcode res = CURLE_FAILED_INIT;
         string readBuffer;
+        int64_t start = HotStats::nowNanos();
 
-        string url = "https://api.twelvedata.com/price?symbol=" + symbol + "&apikey=" + apiKey;
+        string url = apiBaseUrl() + "/price?symbol=" + symbol + "&apikey=" + apiKey;
         curl = curl_easy_init();
 
         if (curl) {
             curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
             curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
             curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
+            // Bounded, so a stalled API cannot hang the price loop (or the
+            // stream thread falling back to REST); NOSIGNAL for threaded callers.
+            curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 5L);
+            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+            curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
             res = curl_easy_perform(curl);
             curl_easy_cleanup(curl);
         }
+        curlTime.recordSince(start);
 
-        try {
-            auto j = json::parse(readBuffer);
-            if (j.contains("price")) {
-                return stod(j["price"].get<string>());
-            } else {
-                cerr << "API Error: " << j.dump() << endl;
-            }
-        } catch (exception& e) {
-            cerr << "JSON Parse Error: " << e.what() << endl;
+        if (res != CURLE_OK) {
+            if (error) *error = curl_easy_strerror(res);
+            return -1.0;
         }
-        return -1.0;
+
+        HotStats::ScopedTimer timer(parseTime);
+        return parsePriceResponse(readBuffer, error);
     }
 
     // ---------------------- MODULE ENTRY POINT ----------------------
@@ -96,9 +87,15 @@ namespace RealTimeTracker {
         string symbol;
 
         RealTimePriceTracker tracker(10);
+        HotStats::startPeriodicDumpFromEnv();
+
+        // Binary feed for local subscribers (Node bridge, dashboards).
+        TickRing::Producer ring;
+        if (!ring.open(TickRing::defaultName("real_time_tracker")))
+            cerr << "Tick ring unavailable (in use by another tracker?), streaming disabled.\n";
 
         cout << " Real-Time Price Tracker Started!\n";
-        cout << "Enter stock symbols one by one (type 'exit' to quit).\n\n";
+        cout << "Enter stock symbols one by one (type 'exit' to quit, 'stats' for timings).\n\n";
 
         while (true) {
             cout << "Enter Stock Symbol: ";
@@ -108,15 +105,25 @@ namespace RealTimeTracker {
                 cout << "👋 Exiting Real-Time Tracker. Goodbye!\n";
                 break;
             }
+            if (symbol == "stats" || symbol == "STATS") {
+                HotStats::printStats(cout);
+                continue;
+            }
 
-            double price = getStockPrice(symbol, apiKey);
+            string error;
+            double price = getStockPrice(symbol, apiKey, &error);
 
             if (price > 0) {
                 cout << "\nCurrent price of " << symbol << ": $" << price << endl;
                 tracker.addPrice(price);
                 tracker.printStats();
+
+                double mn, mx, avg;
+                tracker.getStats(mn, mx, avg);
+                ring.publishTick(symbol, price);
+                ring.publishStats(symbol, price, mn, mx, avg);
             } else {
-                cerr << "Failed to fetch price for " << symbol << ".\n";
+                cerr << "Failed to fetch price for " << symbol << ": " << error << "\n";
             }
 
             cout << "\n Waiting 5 seconds before next input...\n";
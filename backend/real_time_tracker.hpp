@@ -0,0 +1,68 @@
+// real_time_tracker.hpp
+#pragma once
+
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include "hot_stats.hpp"
+#include "rolling_window.hpp"
+
+namespace RealTimeTracker {
+
+    // ---------------------- Real-Time Tracker Class ----------------------
+    // A RollingStats::Window (O(1) add, no allocation) behind a mutex.
+    class RealTimePriceTracker {
+    private:
+        RollingStats::Window window;
+        std::mutex mtx;
+        HotStats::LocalCounter ticks{tickCounter()};
+
+    public:
+        RealTimePriceTracker(size_t n = 10) : window(n) {}
+        ~RealTimePriceTracker() { ticks.set(window.count()); }
+
+        static const HotStats::Counter& tickCounter() {
+            static const HotStats::Counter c = HotStats::counter(
+                "investedge_ticks_total", "tracker=\"real_time_tracker\"",
+                "Prices added to a tracker's rolling window.");
+            return c;
+        }
+
+        void addPrice(double price) {
+            std::lock_guard<std::mutex> lock(mtx);
+            window.add(price);
+        }
+
+        void getStats(double& min, double& max, double& avg) {
+            std::lock_guard<std::mutex> lock(mtx);
+            ticks.set(window.count());          // tick count is published on read, not per add
+            min = window.min();
+            max = window.max();
+            avg = window.average();
+        }
+
+        void printStats() {
+            double min, max, avg;
+            getStats(min, max, avg);
+            std::cout << std::fixed << std::setprecision(2);
+
+            std::cout << "Min: $" << min
+                      << " | Max: $" << max
+                      << " | Avg: $" << avg << "\n";
+        }
+    };
+
+    // ---------------------- CURL JSON Fetching ----------------------
+    size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* output);
+    std::string apiBaseUrl();
+    // Both return -1 on failure and leave the reason in *error (when given)
+    // instead of printing it; the caller decides how to report it.
+    double parsePriceResponse(const std::string& body, std::string* error = nullptr);
+    double getStockPrice(const std::string& symbol, const std::string& apiKey,
+                         std::string* error = nullptr);
+
+    // ---------------------- MODULE ENTRY POINT ----------------------
+    void run();
+
+} // namespace RealTimeTracker
@@ -1,61 +1,25 @@
-// g++ real_time_tracker_with_risk.cpp -o build/real_time_tracker_with_risk -std=c++17 -lcurl -pthread
+// g++ risk_management.cpp mains/risk_management.cpp -o build/real_time_tracker_with_risk -std=c++17 -lcurl -pthread -lrt
 #include <iostream>
+#include <sstream>
 #include <iomanip>
 #include <string>
-#include <deque>
-#include <set>
-#include <mutex>
+#include <cstdlib>
 #include <thread>
 #include <chrono>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 #include <curl/curl.h>
 #include "json.hpp"   // https://github.com/nlohmann/json
+#include "tick_ring.hpp"
+#include "risk_management.hpp"
+#include "hot_stats.hpp"
 
 using json = nlohmann::json;
 using namespace std;
 
 namespace RealTimeTrackerWithRisk {
 
-/* ---------------------- Real-Time Tracker ---------------------- */
-class RealTimePriceTracker {
-private:
-    deque<double> window;
-    multiset<double> bst;
-    size_t window_size;
-    double sum;
-    mutex mtx;
-
-public:
-    RealTimePriceTracker(size_t n = 10) : window_size(n), sum(0.0) {}
-
-    void addPrice(double price) {
-        lock_guard<mutex> lock(mtx);
-        window.push_back(price);
-        bst.insert(price);
-        sum += price;
-        if (window.size() > window_size) {
-            double old = window.front();
-            window.pop_front();
-            bst.erase(bst.find(old));
-            sum -= old;
-        }
-    }
-
-    double getAverage() const {
-        if (window.empty()) return NAN;
-        return sum / window.size();
-    }
-
-    double getMin() const { return bst.empty() ? NAN : *bst.begin(); }
-    double getMax() const { return bst.empty() ? NAN : *bst.rbegin(); }
-
-    void printStats() const {
-        cout << fixed << setprecision(2);
-        cout << "Min: $" << getMin()
-             << " | Max: $" << getMax()
-             << " | Avg: $" << getAverage() << "\n";
-    }
-};
-
 /* ---------------------- CURL JSON Fetching ---------------------- */
 size_t WriteCallback(void* contents, size_t size, size_t nmemb, string* output) {
     size_t totalSize = size * nmemb;
@@ -63,28 +27,58 @@ size_t WriteCallback(void* contents, size_t size, size_t nmemb, string* output)
     return totalSize;
 }
 
-double getStockPrice(const string& symbol, const string& apiKey) {
+// Overridable with TWELVEDATA_BASE_URL (e.g. a local stub server).
+string apiBaseUrl() {
+    const char* env = getenv("TWELVEDATA_BASE_URL");
+    return env && *env ? string(env) : "https://api.twelvedata.com";
+}
+
+double parsePriceResponse(const string& body, string* error) {
+    try {
+        auto j = json::parse(body);
+        if (j.contains("price")) return stod(j["price"].get<string>());
+        if (error) *error = "API error: " + j.dump();
+    } catch (exception& e) {
+        if (error) *error = string("JSON parse error: ") + e.what();
+    }
+    return -1.0;
+}
+
+double getStockPrice(const string& symbol, const string& apiKey, string* error) {
+    static const HotStats::Histogram curlTime = HotStats::histogram(
+        "investedge_price_fetch_seconds", "module=\"real_time_tracker_with_risk\",phase=\"curl\"",
+        "Time spent in getStockPrice, split into HTTP transfer and JSON parsing.");
+    static const HotStats::Histogram parseTime = HotStats::histogram(
+        "investedge_price_fetch_seconds", "module=\"real_time_tracker_with_risk\",phase=\"parse\"",
+        "Time spent in getStockPrice, split into HTTP transfer and JSON parsing.");
+
     CURL* curl;
-    CURLcode res;
+    CURLcode res = CURLE_FAILED_INIT;
     string readBuffer;
-    string url = "https://api.twelvedata.com/price?symbol=" + symbol + "&apikey=" + apiKey;
+    int64_t start = HotStats::nowNanos();
+    string url = apiBaseUrl() + "/price?symbol=" + symbol + "&apikey=" + apiKey;
     curl = curl_easy_init();
 
     if (curl) {
         curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
+        // A stalled API must not freeze the alert loop.
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 5L);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
         res = curl_easy_perform(curl);
         curl_easy_cleanup(curl);
     }
+    curlTime.recordSince(start);
 
-    try {
-        auto j = json::parse(readBuffer);
-        if (j.contains("price")) return stod(j["price"].get<string>());
-    } catch (exception& e) {
-        cerr << "JSON Parse Error: " << e.what() << endl;
+    if (res != CURLE_OK) {
+        if (error) *error = curl_easy_strerror(res);
+        return -1.0;
     }
-    return -1.0;
+
+    HotStats::ScopedTimer timer(parseTime);
+    return parsePriceResponse(readBuffer, error);
 }
 
 /* ---------------------- ENTRY POINT ---------------------- */
@@ -94,6 +88,22 @@ void run() {
     double stopLoss = 0.0, target = 0.0;
 
     RealTimePriceTracker tracker(10);
+    HotStats::startPeriodicDumpFromEnv();
+
+    static const HotStats::Histogram tickToAlert = HotStats::histogram(
+        "investedge_tick_to_alert_seconds", "",
+        "Delay from a fetched price being in hand to its stop-loss/target alert being emitted.");
+    static const HotStats::Histogram fetchToAlert = HotStats::histogram(
+        "investedge_fetch_to_alert_seconds", "",
+        "Delay from requesting a price (fetch included) to its stop-loss/target alert being emitted.");
+    static const HotStats::Counter stopLossAlerts = HotStats::counter(
+        "investedge_alerts_total", "type=\"stop_loss\"", "Risk alerts emitted.");
+    static const HotStats::Counter targetAlerts = HotStats::counter(
+        "investedge_alerts_total", "type=\"target\"", "Risk alerts emitted.");
+
+    TickRing::Producer ring;
+    if (!ring.open(TickRing::defaultName("real_time_tracker_with_risk")))
+        cerr << "Tick ring unavailable (in use by another tracker?), streaming disabled.\n";
 
     cout << "📈 Real-Time Price Tracker with Risk Management\n";
     cout << "Enter Stock Symbol (type 'exit' to quit): ";
@@ -108,25 +118,74 @@ void run() {
     cout << "\nMonitoring " << symbol
          << " | Stop-Loss: $" << stopLoss
          << " | Target: $" << target << "\n";
+    cout << "(type 'stats' for timings, 'exit' to stop)\n";
+
+    // Console commands while monitoring. Shared state outlives run() because
+    // the reader thread may still be blocked on cin when we return. `output`
+    // serializes whole blocks on cout; only the monitoring loop sets cout's
+    // format, so `stats` is formatted into its own stream first.
+    struct Console {
+        mutex mtx;
+        condition_variable wake;
+        bool stop = false;
+        mutex output;
+    };
+    auto console = make_shared<Console>();
+    thread([console] {
+        string cmd;
+        while (cin >> cmd) {
+            if (cmd == "stats" || cmd == "STATS") {
+                ostringstream stats;
+                HotStats::printStats(stats);
+                lock_guard<mutex> lock(console->output);
+                cout << stats.str() << flush;
+            } else if (cmd == "exit" || cmd == "EXIT") {
+                lock_guard<mutex> lock(console->mtx);
+                console->stop = true;
+                console->wake.notify_all();
+                return;
+            }
+        }
+    }).detach();
 
     while (true) {
-        double price = getStockPrice(symbol, apiKey);
+        int64_t fetchNs = HotStats::nowNanos();
+        string error;
+        double price = getStockPrice(symbol, apiKey, &error);
+        int64_t tickNs = HotStats::nowNanos();      // tracker update, check and emit from here
+        unique_lock<mutex> out(console->output);
         if (price <= 0) {
-            cerr << "⚠️  Failed to fetch price for " << symbol << ". Retrying...\n";
+            cerr << "⚠️  Failed to fetch price for " << symbol << ": " << error << ". Retrying...\n";
         } else {
             cout << "\nCurrent price of " << symbol << ": $" << price << endl;
             tracker.addPrice(price);
             tracker.printStats();
+            ring.publishTick(symbol, price);
+            ring.publishStats(symbol, price, tracker.getMin(), tracker.getMax(), tracker.getAverage());
 
-            if (price <= stopLoss)
+            Alert alert = checkAlert(price, stopLoss, target);
+            if (alert == Alert::StopLoss) {
                 cout << "🚨 [ALERT] Stop-Loss triggered! Price fell to $" << price << "\n";
-            else if (price >= target)
+                tickToAlert.recordSince(tickNs);
+                fetchToAlert.recordSince(fetchNs);
+                stopLossAlerts.inc();
+            } else if (alert == Alert::Target) {
                 cout << "🎯 [ALERT] Target reached! Price rose to $" << price << "\n";
+                tickToAlert.recordSince(tickNs);
+                fetchToAlert.recordSince(fetchNs);
+                targetAlerts.inc();
+            }
         }
 
         cout << "⏳ Waiting 30 seconds for next update...\n";
-        cout << "---------------------------------------------\n";
-        this_thread::sleep_for(chrono::seconds(30));
+        cout << "---------------------------------------------" << endl;
+        out.unlock();
+        unique_lock<mutex> lock(console->mtx);
+        if (console->wake.wait_for(lock, chrono::seconds(30), [&] { return console->stop; })) {
+            lock_guard<mutex> bye(console->output);
+            cout << "👋 Stopped monitoring " << symbol << ".\n";
+            return;
+        }
     }
 }
 
@@ -0,0 +1,76 @@
+// risk_management.hpp
+#pragma once
+
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include "hot_stats.hpp"
+#include "rolling_window.hpp"
+
+namespace RealTimeTrackerWithRisk {
+
+/* ---------------------- Real-Time Tracker ---------------------- */
+// A RollingStats::Window behind a mutex, counting into investedge_ticks_total.
+class RealTimePriceTracker {
+private:
+    RollingStats::Window window;
+    mutable std::mutex mtx;
+    HotStats::LocalCounter ticks{tickCounter()};
+
+public:
+    RealTimePriceTracker(size_t n = 10) : window(n) {}
+    ~RealTimePriceTracker() { ticks.set(window.count()); }
+
+    static const HotStats::Counter& tickCounter() {
+        static const HotStats::Counter c = HotStats::counter(
+            "investedge_ticks_total", "tracker=\"real_time_tracker_with_risk\"",
+            "Prices added to a tracker's rolling window.");
+        return c;
+    }
+
+    void addPrice(double price) {
+        std::lock_guard<std::mutex> lock(mtx);
+        window.add(price);
+    }
+
+    size_t size() const { std::lock_guard<std::mutex> lock(mtx); return window.size(); }
+    bool full() const { std::lock_guard<std::mutex> lock(mtx); return window.full(); }
+    double getAverage() const { std::lock_guard<std::mutex> lock(mtx); return window.average(); }
+    double getMin() const { std::lock_guard<std::mutex> lock(mtx); return window.min(); }
+    double getMax() const { std::lock_guard<std::mutex> lock(mtx); return window.max(); }
+
+    void printStats() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            ticks.set(window.count());         // tick count is published on read, not per add
+        }
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Min: $" << getMin()
+                  << " | Max: $" << getMax()
+                  << " | Avg: $" << getAverage() << "\n";
+    }
+};
+
+/* ---------------------- Risk Alerts ---------------------- */
+enum class Alert { None, StopLoss, Target };
+
+// Same rule live and in backtests: stop-loss wins if both thresholds are crossed.
+inline Alert checkAlert(double price, double stopLoss, double target) {
+    if (price <= stopLoss) return Alert::StopLoss;
+    if (price >= target) return Alert::Target;
+    return Alert::None;
+}
+
+/* ---------------------- CURL JSON Fetching ---------------------- */
+size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* output);
+std::string apiBaseUrl();
+// -1 on failure, with the reason in *error (when given); nothing is printed.
+double parsePriceResponse(const std::string& body, std::string* error = nullptr);
+double getStockPrice(const std::string& symbol, const std::string& apiKey,
+                     std::string* error = nullptr);
+
+/* ---------------------- ENTRY POINT ---------------------- */
+void run();
+
+} // namespace RealTimeTrackerWithRisk
@@ -0,0 +1,73 @@
+// rolling_window.hpp
+// Rolling min/max/average over the last N prices, shared by both real-time
+// trackers and the backtester. The window is a ring buffer and min/max come
+// from monotonic queues, so add() is O(1) amortized and never allocates.
+// No locking and no metrics: the trackers wrap it with both, while a
+// backtest sweep owns one per symbol per parameter set and counts once.
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace RollingStats {
+
+class Window {
+private:
+    struct Entry { uint64_t seq; double price; };
+
+    // Fixed-capacity FIFO that can also pop from the back.
+    struct MonoQueue {
+        std::vector<Entry> buf;
+        size_t head = 0, len = 0;
+
+        explicit MonoQueue(size_t cap) : buf(cap) {}
+        size_t at(size_t i) const { size_t j = head + i; return j >= buf.size() ? j - buf.size() : j; }
+        bool empty() const { return len == 0; }
+        const Entry& front() const { return buf[head]; }
+        const Entry& back() const { return buf[at(len - 1)]; }
+        void popFront() { if (++head == buf.size()) head = 0; len--; }
+        void popBack() { len--; }
+        void pushBack(const Entry& e) { buf[at(len)] = e; len++; }
+    };
+
+    std::vector<double> window;      // ring of the last windowSize prices
+    MonoQueue minQ, maxQ;            // increasing / decreasing prices
+    size_t windowSize;
+    size_t pos = 0;                  // next ring slot
+    uint64_t seen = 0;               // prices added so far
+    double sum = 0.0;
+
+public:
+    explicit Window(size_t n = 10) : window(n), minQ(n + 1), maxQ(n + 1), windowSize(n) {}
+
+    void add(double price) {
+        if (windowSize == 0) return;
+
+        uint64_t seq = seen++;
+        if (seq >= windowSize) sum -= window[pos];   // evict the oldest price
+        window[pos] = price;
+        sum += price;
+        if (++pos == windowSize) pos = 0;
+
+        uint64_t oldest = seen > windowSize ? seen - windowSize : 0;
+        while (!minQ.empty() && minQ.back().price >= price) minQ.popBack();
+        minQ.pushBack({seq, price});
+        while (minQ.front().seq < oldest) minQ.popFront();
+
+        while (!maxQ.empty() && maxQ.back().price <= price) maxQ.popBack();
+        maxQ.pushBack({seq, price});
+        while (maxQ.front().seq < oldest) maxQ.popFront();
+    }
+
+    size_t size() const { return (size_t)std::min<uint64_t>(seen, windowSize); }
+    uint64_t count() const { return seen; }
+    bool full() const { return windowSize > 0 && seen >= windowSize; }
+
+    double average() const { return size() == 0 ? NAN : sum / size(); }
+    double min() const { return minQ.empty() ? NAN : minQ.front().price; }
+    double max() const { return maxQ.empty() ? NAN : maxQ.front().price; }
+};
+
+} // namespace RollingStats
@@ -28,20 +28,91 @@ function resolveBinary(name) {
 
 const sessions = new Map();
 
+// Each tracker session publishes into its own shared-memory ring (the ring
+// has a single writer), named through INVESTEDGE_TICK_RING. One
+// tick_ring_reader per ring turns records into JSON lines, broadcast in
+// batches ('ticks') to the ring's socket.io room, which feeds the dashboard's
+// Live Prices panel; the reader is killed once the room is empty.
+const TICK_RING_APPS = new Set(['real_time_tracker', 'real_time_tracker_with_risk', 'price_stream']);
+const ringReaders = new Map();
+let ringSeq = 0;
+
+function ringNameFor(appName) {
+  if (!TICK_RING_APPS.has(appName)) return null;
+  return `/investedge_${appName}_${process.pid}_${++ringSeq}`;
+}
+
+function subscribeTicks(socket, ring) {
+  if (!ring) return;
+  socket.join(ring);
+  if (ringReaders.has(ring)) return;
+
+  const bin = resolveBinary('tick_ring_reader');
+  if (!bin) return;
+  const reader = spawn(bin, [ring], { cwd: process.cwd() });
+  ringReaders.set(ring, reader);
+
+  let pending = '';
+  reader.stdout.on('data', d => {
+    pending += d.toString();
+    const lines = pending.split('\n');
+    pending = lines.pop();
+    const records = [];
+    for (const line of lines) {
+      if (!line) continue;
+      try { records.push(JSON.parse(line)); } catch (e) {
+        console.warn(`tick_ring_reader ${ring}: bad record (${e.message}): ${line}`);
+      }
+    }
+    // One event per chunk: a streaming tracker can publish far more records
+    // per second than socket.io handles as separate messages.
+    if (records.length) io.to(ring).emit('ticks', records);
+  });
+  reader.on('close', () => { if (ringReaders.get(ring) === reader) ringReaders.delete(ring); });
+  reader.on('error', () => { if (ringReaders.get(ring) === reader) ringReaders.delete(ring); });
+}
+
+function unsubscribeTicks(socket, ring) {
+  if (!ring) return;
+  socket.leave(ring);
+  if ((io.sockets.adapter.rooms.get(ring)?.size ?? 0) > 0) return;
+  const reader = ringReaders.get(ring);
+  if (reader) { try { reader.kill('SIGTERM'); } catch {} ringReaders.delete(ring); }
+  // The tracker is killed without a chance to unlink its segment.
+  fs.rm(path.join('/dev/shm', ring), { force: true }, () => {});
+}
+
+function endSession(socket) {
+  const s = sessions.get(socket.id);
+  if (!s) return false;
+  if (s.proc) { try { s.proc.kill('SIGKILL'); } catch {} }
+  unsubscribeTicks(socket, s.ring);
+  sessions.delete(socket.id);
+  return true;
+}
+
 io.on('connection', (socket) => {
   socket.on('start', ({ appName }) => {
     if (sessions.has(socket.id)) { socket.emit('errorMsg', 'A process is already running. Stop it first.'); return; }
     const bin = resolveBinary(appName);
     if (!bin) { socket.emit('errorMsg', `Binary not found for ${appName}. Expected in ./build or ../build`); return; }
-    const child = spawn(bin, [], { cwd: process.cwd() });
+    const ring = ringNameFor(appName);
+    const env = { ...process.env };
+    if (ring) env.INVESTEDGE_TICK_RING = ring;
+    // mark_to_market follows the most recently started tracker still running.
+    const live = [...sessions.values()].filter(s => s.ring).pop();
+    if (appName === 'mark_to_market' && live) env.INVESTEDGE_FOLLOW_RING = live.ring;
+    const child = spawn(bin, [], { cwd: process.cwd(), env });
 
-    sessions.set(socket.id, { proc: child, appName });
+    sessions.set(socket.id, { proc: child, appName, ring });
 
     socket.emit('status', `Started ${appName}`);
+    subscribeTicks(socket, ring);
     child.stdout.on('data', d => socket.emit('stdout', d.toString()));
     child.stderr.on('data', d => socket.emit('stderr', d.toString()));
-    child.on('close', (code) => { socket.emit('status', `Exited (${code})`); sessions.delete(socket.id); });
-    child.on('error', (err) => { socket.emit('errorMsg', err.message); sessions.delete(socket.id); });
+    const exited = () => { if (sessions.get(socket.id)?.proc === child) endSession(socket); };
+    child.on('close', (code) => { socket.emit('status', `Exited (${code})`); exited(); });
+    child.on('error', (err) => { socket.emit('errorMsg', err.message); exited(); });
   });
 
   socket.on('sendInput', (text) => {
@@ -51,14 +122,10 @@ io.on('connection', (socket) => {
   });
 
   socket.on('stop', () => {
-    const s = sessions.get(socket.id);
-    if (s?.proc) { try { s.proc.kill('SIGKILL'); } catch {} sessions.delete(socket.id); socket.emit('status', 'Stopped'); }
+    if (endSession(socket)) socket.emit('status', 'Stopped');
   });
 
-  socket.on('disconnect', () => {
-    const s = sessions.get(socket.id);
-    if (s?.proc) { try { s.proc.kill('SIGKILL'); } catch {} sessions.delete(socket.id); }
-  });
+  socket.on('disconnect', () => endSession(socket));
 });
 
 app.get('/health', (_req, res) => res.json({ ok: true }));
@@ -66,5 +133,5 @@ app.get('/health', (_req, res) => res.json({ ok: true }));
 const PORT = process.env.PORT || 5055;
 httpServer.listen(PORT, () => {
   console.log(`InvestEdge Backend on http://localhost:${PORT}`);
-  console.log('Place compiled binaries in ./build (profit_loss, real_time_tracker, stock_news)');
+  console.log('Place compiled binaries in ./build (profit_loss, real_time_tracker, stock_news, tick_ring_reader)');
 });
\ No newline at end of file
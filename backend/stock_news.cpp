@@ -1,7 +1,10 @@
 #include <iostream>
 #include <string>
+#include <cstdlib>
 #include <curl/curl.h>
 #include "json.hpp"  // Include nlohmann/json header
+#include "stock_news.hpp"
+#include "hot_stats.hpp"
 
 using json = nlohmann::json;
 using namespace std;
@@ -16,43 +19,23 @@ namespace StockNews {
     }
 
     // ======== FETCH STOCK NEWS ========
-    void FetchStockNews() {
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            cerr << " CURL initialization failed\n";
-            return;
-        }
-
-        string apiKey = "YOUR_API_KEY"; 
-        string url = "https://newsapi.org/v2/everything?q=finance%20OR%20stocks%20OR%20business&sortBy=publishedAt&pageSize=15&language=en&apiKey=" + apiKey;
-        string readBuffer;
-
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-
-        struct curl_slist* headers = nullptr;
-        headers = curl_slist_append(headers, "User-Agent: StockNewsApp/1.0");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-        CURLcode res = curl_easy_perform(curl);
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
-
-        if (res != CURLE_OK) {
-            cerr << "Failed to fetch news: " << curl_easy_strerror(res) << endl;
-            return;
-        }
+    // Overridable with NEWSAPI_BASE_URL (e.g. a local stub server).
+    string apiBaseUrl() {
+        const char* env = getenv("NEWSAPI_BASE_URL");
+        return env && *env ? string(env) : "https://newsapi.org";
+    }
 
+    // Prints the headlines in a NewsAPI response; returns how many were printed.
+    int PrintStockNews(const string& body) {
+        int count = 0;
         try {
-            json data = json::parse(readBuffer);
+            json data = json::parse(body);
             if (data["status"] != "ok") {
                 cout << "API Error: " << data["message"] << endl;
-                return;
+                return 0;
             }
 
             cout << "\n===== 📰 Top 15 Stock Market Headlines =====\n";
-            int count = 0;
 
             for (auto& article : data["articles"]) {
                 count++;
@@ -76,6 +59,48 @@ namespace StockNews {
         } catch (exception& e) {
             cerr << " JSON Parsing Error: " << e.what() << endl;
         }
+        return count;
+    }
+
+    void FetchStockNews() {
+        static const HotStats::Histogram curlTime = HotStats::histogram(
+            "investedge_news_fetch_seconds", "phase=\"curl\"",
+            "Time spent in FetchStockNews, split into HTTP transfer and parsing/printing.");
+        static const HotStats::Histogram parseTime = HotStats::histogram(
+            "investedge_news_fetch_seconds", "phase=\"parse\"",
+            "Time spent in FetchStockNews, split into HTTP transfer and parsing/printing.");
+        int64_t start = HotStats::nowNanos();
+
+        CURL* curl = curl_easy_init();
+        if (!curl) {
+            cerr << " CURL initialization failed\n";
+            return;
+        }
+
+        string apiKey = "YOUR_API_KEY"; 
+        string url = apiBaseUrl() + "/v2/everything?q=finance%20OR%20stocks%20OR%20business&sortBy=publishedAt&pageSize=15&language=en&apiKey=" + apiKey;
+        string readBuffer;
+
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
+
+        struct curl_slist* headers = nullptr;
+        headers = curl_slist_append(headers, "User-Agent: StockNewsApp/1.0");
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+
+        CURLcode res = curl_easy_perform(curl);
+        curl_slist_free_all(headers);
+        curl_easy_cleanup(curl);
+        curlTime.recordSince(start);
+
+        if (res != CURLE_OK) {
+            cerr << "Failed to fetch news: " << curl_easy_strerror(res) << endl;
+            return;
+        }
+
+        HotStats::ScopedTimer timer(parseTime);
+        PrintStockNews(readBuffer);
     }
 
     // ======== MODULE ENTRY POINT ========
@@ -0,0 +1,19 @@
+// stock_news.hpp
+#pragma once
+
+#include <string>
+
+namespace StockNews {
+
+    // ======== WRITE CALLBACK ========
+    size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* output);
+
+    // ======== FETCH STOCK NEWS ========
+    std::string apiBaseUrl();
+    int PrintStockNews(const std::string& body);
+    void FetchStockNews();
+
+    // ======== MODULE ENTRY POINT ========
+    void run();
+
+} // namespace StockNews
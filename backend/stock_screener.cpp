@@ -0,0 +1,552 @@
+// stock_screener.cpp
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "stock_screener.hpp"
+#include "parallel.hpp"
+#include "hot_stats.hpp"
+
+using namespace std;
+
+namespace StockScreener {
+
+using PortfolioAnalyzer::Stock;
+
+constexpr size_t CHUNK_ROWS  = 16384;            // rows per parallel task
+constexpr size_t CHUNK_WORDS = CHUNK_ROWS / 64;
+// Parser nesting and tree height limit. Both recurse per level, and eval
+// keeps a CHUNK_WORDS scratch bitmap (2 KB) per AND/OR level, so 256 levels
+// stay well inside a worker thread's stack.
+constexpr int MAX_DEPTH = 256;
+
+using Parallel::parallelFor;
+
+/*===========================
+   Column Table
+===========================*/
+static const char* const FIELD_NAMES[FIELD_COUNT] = {
+    "price", "prevClose", "changePercent", "marketCap", "sector", "symbol", "name"};
+
+static string normalize(const string& s) {
+    string r;
+    for (char c : s)
+        if (c != '_') r += (char)tolower((unsigned char)c);
+    return r;
+}
+
+bool parseField(const string& name, Field& out) {
+    string n = normalize(name);
+    for (int f = 0; f < FIELD_COUNT; f++)
+        if (n == normalize(FIELD_NAMES[f])) {
+            out = (Field)f;
+            return true;
+        }
+    return false;
+}
+
+const char* fieldName(Field f) { return FIELD_NAMES[f]; }
+
+const double* Table::numeric(Field f) const {
+    switch (f) {
+    case PRICE:          return price.data();
+    case PREV_CLOSE:     return prevClose.data();
+    case CHANGE_PERCENT: return changePercent.data();
+    case MARKET_CAP:     return marketCap.data();
+    default:             return nullptr;
+    }
+}
+
+Table buildTable(const vector<Stock>& stocks) {
+    Table t;
+    t.rows = stocks.size();
+    t.source = &stocks;
+    t.price.resize(t.rows);
+    t.prevClose.resize(t.rows);
+    t.changePercent.resize(t.rows);
+    t.marketCap.resize(t.rows);
+    t.sector.resize(t.rows);
+
+    unordered_map<string, uint32_t> codes;
+    for (size_t i = 0; i < t.rows; i++) {
+        const Stock& s = stocks[i];
+        t.price[i] = s.price;
+        t.prevClose[i] = s.prevClose;
+        t.changePercent[i] = s.changePercent;
+        t.marketCap[i] = s.marketCap;
+        auto c = codes.emplace(s.sector, (uint32_t)t.sectorNames.size());
+        if (c.second) t.sectorNames.push_back(s.sector);
+        t.sector[i] = c.first->second;
+    }
+    return t;
+}
+
+/*===========================
+   Parser
+===========================*/
+// Recursive descent over the expression text, emitting Screen nodes.
+class Parser {
+public:
+    Parser(const string& text, const Table& table, Screen& screen)
+        : src(text), tbl(table), out(screen) {}
+
+    bool parse() {
+        out.nodes.clear();
+        height.clear();
+        skipSpace();
+        if (pos == src.size()) {
+            out.root = add(Node());
+            return true;
+        }
+        out.root = parseOr();
+        if (out.root < 0) return false;
+        skipSpace();
+        if (pos != src.size()) return fail("unexpected '" + src.substr(pos, 12) + "'");
+        return true;
+    }
+
+private:
+    using Node = Screen::Node;
+
+    const string& src;
+    const Table& tbl;
+    Screen& out;
+    size_t pos = 0;
+    int nesting = 0;              // parseUnary calls in progress
+    vector<int> height;           // per node: levels of eval recursion below it, itself included
+
+    bool fail(const string& msg) {
+        cout << "Error: " << msg << " at column " << pos + 1 << " of screen expression\n";
+        return false;
+    }
+
+    int add(const Node& n) {
+        out.nodes.push_back(n);
+        height.push_back(1 + max(n.left >= 0 ? height[n.left] : 0, n.right >= 0 ? height[n.right] : 0));
+        if (height.back() > MAX_DEPTH) {
+            fail("expression nested more than " + to_string(MAX_DEPTH) + " levels deep");
+            return -1;
+        }
+        return (int)out.nodes.size() - 1;
+    }
+
+    void skipSpace() {
+        while (pos < src.size() && isspace((unsigned char)src[pos])) pos++;
+    }
+
+    bool accept(const char* tok) {
+        skipSpace();
+        size_t n = strlen(tok);
+        if (src.compare(pos, n, tok) != 0) return false;
+        pos += n;
+        return true;
+    }
+
+    // Keywords must not run into an identifier ("order" is not "or").
+    bool acceptWord(const char* word) {
+        skipSpace();
+        size_t n = strlen(word), start = pos;
+        if (pos + n > src.size()) return false;
+        for (size_t i = 0; i < n; i++)
+            if (tolower((unsigned char)src[pos + i]) != word[i]) return false;
+        pos += n;
+        if (pos < src.size() && (isalnum((unsigned char)src[pos]) || src[pos] == '_')) {
+            pos = start;
+            return false;
+        }
+        return true;
+    }
+
+    int binary(Screen::Kind kind, int l, int r) {
+        Node n;
+        n.kind = kind;
+        n.left = l;
+        n.right = r;
+        return add(n);
+    }
+
+    int parseOr() {
+        int l = parseAnd();
+        while (l >= 0 && (accept("||") || acceptWord("or"))) {
+            int r = parseAnd();
+            if (r < 0) return -1;
+            l = binary(Screen::OR, l, r);
+        }
+        return l;
+    }
+
+    int parseAnd() {
+        int l = parseUnary();
+        while (l >= 0 && (accept("&&") || acceptWord("and"))) {
+            int r = parseUnary();
+            if (r < 0) return -1;
+            l = binary(Screen::AND, l, r);
+        }
+        return l;
+    }
+
+    int parseUnary() {
+        if (nesting == MAX_DEPTH) {
+            fail("expression nested more than " + to_string(MAX_DEPTH) + " levels deep");
+            return -1;
+        }
+        nesting++;
+        int n = parseUnaryBody();
+        nesting--;
+        return n;
+    }
+
+    int parseUnaryBody() {
+        skipSpace();
+        if ((src.compare(pos, 2, "!=") != 0 && accept("!")) || acceptWord("not")) {
+            int c = parseUnary();
+            return c < 0 ? -1 : binary(Screen::NOT, c, -1);
+        }
+        if (accept("(")) {
+            int e = parseOr();
+            if (e < 0) return -1;
+            if (!accept(")")) { fail("expected ')'"); return -1; }
+            return e;
+        }
+        return parseComparison();
+    }
+
+    // One side of a comparison: a field, a number or a quoted string.
+    struct Operand {
+        enum { FIELD, NUMBER, TEXT } kind;
+        Field field;
+        double number;
+        string text;
+    };
+
+    bool parseOperand(Operand& o) {
+        skipSpace();
+        if (pos == src.size()) return fail("expected a field or value");
+        char c = src[pos];
+        if (c == '"' || c == '\'') {
+            size_t end = src.find(c, pos + 1);
+            if (end == string::npos) return fail("unterminated string");
+            o.kind = Operand::TEXT;
+            o.text = src.substr(pos + 1, end - pos - 1);
+            pos = end + 1;
+            return true;
+        }
+        if (isalpha((unsigned char)c) || c == '_') {
+            size_t start = pos;
+            while (pos < src.size() && (isalnum((unsigned char)src[pos]) || src[pos] == '_')) pos++;
+            string word = src.substr(start, pos - start);
+            o.kind = Operand::FIELD;
+            if (!parseField(word, o.field)) {
+                pos = start;
+                return fail("unknown field '" + word + "' (quote text values)");
+            }
+            return true;
+        }
+        const char* begin = src.c_str() + pos;
+        char* end;
+        o.number = strtod(begin, &end);
+        if (end == begin) return fail("expected a field or value");
+        o.kind = Operand::NUMBER;
+        pos += end - begin;
+        return true;
+    }
+
+    bool parseOp(Screen::Op& op) {
+        if (accept("==")) op = Screen::EQ;
+        else if (accept("!=")) op = Screen::NE;
+        else if (accept("<=")) op = Screen::LE;
+        else if (accept(">=")) op = Screen::GE;
+        else if (accept("<")) op = Screen::LT;
+        else if (accept(">")) op = Screen::GT;
+        else if (accept("=")) op = Screen::EQ;
+        else return fail("expected a comparison operator");
+        return true;
+    }
+
+    static Screen::Op mirror(Screen::Op op) {
+        switch (op) {
+        case Screen::LT: return Screen::GT;
+        case Screen::LE: return Screen::GE;
+        case Screen::GT: return Screen::LT;
+        case Screen::GE: return Screen::LE;
+        default:         return op;
+        }
+    }
+
+    int parseComparison() {
+        Operand a, b;
+        Screen::Op op;
+        if (!parseOperand(a) || !parseOp(op) || !parseOperand(b)) return -1;
+        if (a.kind != Operand::FIELD) {
+            swap(a, b);
+            op = mirror(op);
+        }
+        if (a.kind != Operand::FIELD) { fail("a comparison needs at least one field"); return -1; }
+
+        bool text = tbl.numeric(a.field) == nullptr;
+        Node n;
+        n.kind = Screen::NUM_CONST;
+        n.op = op;
+        n.field = a.field;
+
+        if (b.kind == Operand::FIELD) {
+            if (text || tbl.numeric(b.field) == nullptr)
+                { fail("only numeric fields can be compared with each other"); return -1; }
+            n.kind = Screen::NUM_FIELD;
+            n.other = b.field;
+            return add(n);
+        }
+        if (!text) {
+            if (b.kind != Operand::NUMBER)
+                { fail(string(fieldName(a.field)) + " needs a number"); return -1; }
+            n.value = b.number;
+            return add(n);
+        }
+        if (b.kind != Operand::TEXT)
+            { fail(string(fieldName(a.field)) + " needs a quoted string"); return -1; }
+        if (op != Screen::EQ && op != Screen::NE)
+            { fail(string(fieldName(a.field)) + " supports only == and !="); return -1; }
+
+        n.text = b.text;
+        if (a.field == SECTOR) {
+            n.kind = Screen::SECTOR_EQ;
+            auto it = find(tbl.sectorNames.begin(), tbl.sectorNames.end(), b.text);
+            n.code = it == tbl.sectorNames.end() ? UINT32_MAX
+                                                 : (uint32_t)(it - tbl.sectorNames.begin());
+        } else {
+            n.kind = Screen::TEXT_EQ;
+        }
+        return add(n);
+    }
+};
+
+bool Screen::compile(const string& expr, const Table& t) {
+    table = &t;
+    Parser p(expr, t, *this);
+    if (p.parse()) return true;
+    nodes.clear();
+    root = -1;
+    return false;
+}
+
+/*===========================
+   Predicate Kernels
+===========================*/
+// Packs 64 0/1 bytes into one word, bit i = b[i]. Each multiply gathers
+// eight bytes into the top byte of the product (no carries between them).
+static inline uint64_t packBits(const uint8_t* b) {
+    uint64_t w = 0;
+    for (int k = 0; k < 8; k++) {
+        uint64_t x;
+        memcpy(&x, b + 8 * k, sizeof(x));
+        w |= ((x * 0x0102040810204080ull) >> 56) << (8 * k);
+    }
+    return w;
+}
+
+// Compares rows [begin, end) 64 at a time: the byte loop has no branches
+// and vectorizes, then each 64-byte block becomes one bitmap word.
+template <typename T, typename Cmp>
+static void compareRows(const T* a, const T* b, T c, size_t begin, size_t end,
+                        uint64_t* out, Cmp cmp) {
+    alignas(64) uint8_t bits[64];
+    for (size_t base = begin; base < end; base += 64) {
+        size_t m = min<size_t>(64, end - base);
+        if (b) for (size_t i = 0; i < m; i++) bits[i] = cmp(a[base + i], b[base + i]);
+        else   for (size_t i = 0; i < m; i++) bits[i] = cmp(a[base + i], c);
+        for (size_t i = m; i < 64; i++) bits[i] = 0;
+        *out++ = packBits(bits);
+    }
+}
+
+template <typename T>
+static void compareOp(int op, const T* a, const T* b, T c, size_t begin, size_t end, uint64_t* out) {
+    switch (op) {
+    case 0: compareRows(a, b, c, begin, end, out, [](T x, T y) -> uint8_t { return x == y; }); break;
+    case 1: compareRows(a, b, c, begin, end, out, [](T x, T y) -> uint8_t { return x != y; }); break;
+    case 2: compareRows(a, b, c, begin, end, out, [](T x, T y) -> uint8_t { return x < y; }); break;
+    case 3: compareRows(a, b, c, begin, end, out, [](T x, T y) -> uint8_t { return x <= y; }); break;
+    case 4: compareRows(a, b, c, begin, end, out, [](T x, T y) -> uint8_t { return x > y; }); break;
+    default: compareRows(a, b, c, begin, end, out, [](T x, T y) -> uint8_t { return x >= y; }); break;
+    }
+}
+
+static uint64_t tailMask(size_t begin, size_t end, size_t word) {
+    size_t rows = end - begin - word * 64;
+    return rows >= 64 ? ~0ull : (1ull << rows) - 1;
+}
+
+void Screen::eval(int id, size_t begin, size_t end, uint64_t* out) const {
+    const Node& n = nodes[id];
+    size_t words = (end - begin + 63) / 64;
+
+    switch (n.kind) {
+    case NUM_CONST:
+        compareOp<double>(n.op, table->numeric(n.field), nullptr, n.value, begin, end, out);
+        break;
+    case NUM_FIELD:
+        compareOp<double>(n.op, table->numeric(n.field), table->numeric(n.other), 0.0, begin, end, out);
+        break;
+    case SECTOR_EQ:
+        compareOp<uint32_t>(n.op, table->sector.data(), nullptr, n.code, begin, end, out);
+        break;
+    case TEXT_EQ: {
+        const vector<Stock>& s = *table->source;
+        bool want = n.op == EQ;
+        for (size_t w = 0; w < words; w++) {
+            uint64_t bits = 0;
+            size_t base = begin + w * 64, m = min<size_t>(64, end - base);
+            for (size_t i = 0; i < m; i++) {
+                const string& v = n.field == SYMBOL ? s[base + i].symbol : s[base + i].name;
+                bits |= (uint64_t)((v == n.text) == want) << i;
+            }
+            out[w] = bits;
+        }
+        break;
+    }
+    case AND:
+    case OR: {
+        eval(n.left, begin, end, out);
+        // Skip the right side when the left already decides the chunk.
+        bool decided = true;
+        for (size_t w = 0; w < words && decided; w++)
+            decided = n.kind == AND ? out[w] == 0 : out[w] == tailMask(begin, end, w);
+        if (decided) break;
+        uint64_t tmp[CHUNK_WORDS];
+        eval(n.right, begin, end, tmp);
+        if (n.kind == AND) for (size_t w = 0; w < words; w++) out[w] &= tmp[w];
+        else               for (size_t w = 0; w < words; w++) out[w] |= tmp[w];
+        break;
+    }
+    case NOT:
+        eval(n.left, begin, end, out);
+        for (size_t w = 0; w < words; w++) out[w] = ~out[w] & tailMask(begin, end, w);
+        break;
+    case ALL:
+        for (size_t w = 0; w < words; w++) out[w] = tailMask(begin, end, w);
+        break;
+    }
+}
+
+vector<uint64_t> Screen::select(unsigned threads) const {
+    if (!table || root < 0) return {};
+    size_t rows = table->rows;
+    vector<uint64_t> bitmap((rows + 63) / 64, 0);
+    threads = Parallel::threadCount(threads);
+
+    size_t chunks = (rows + CHUNK_ROWS - 1) / CHUNK_ROWS;
+    parallelFor(chunks, threads, [&](size_t c) {
+        size_t begin = c * CHUNK_ROWS, end = min(rows, begin + CHUNK_ROWS);
+        eval(root, begin, end, &bitmap[begin / 64]);
+    });
+    return bitmap;
+}
+
+/*===========================
+   Sorting & Results
+===========================*/
+bool parseOrder(const string& spec, Order& out) {
+    string s = spec;
+    s.erase(remove_if(s.begin(), s.end(), [](char c) { return isspace((unsigned char)c); }), s.end());
+    out.sorted = !s.empty();
+    if (s.empty()) return true;
+    out.descending = s[0] == '-';
+    if (s[0] == '-' || s[0] == '+') s.erase(0, 1);
+    if (!parseField(s, out.field)) {
+        cout << "Error: unknown sort field '" << s << "'\n";
+        return false;
+    }
+    return true;
+}
+
+size_t countMatches(const vector<uint64_t>& bitmap) {
+    size_t n = 0;
+    for (uint64_t w : bitmap) n += __builtin_popcountll(w);
+    return n;
+}
+
+vector<uint32_t> orderMatches(const Table& table, const vector<uint64_t>& bitmap, const Order& order) {
+    vector<uint32_t> rows;
+    rows.reserve(countMatches(bitmap));
+    for (size_t w = 0; w < bitmap.size(); w++)
+        for (uint64_t bits = bitmap[w]; bits; bits &= bits - 1)
+            rows.push_back((uint32_t)(w * 64 + __builtin_ctzll(bits)));
+
+    size_t keep = order.limit && order.limit < rows.size() ? order.limit : rows.size();
+    if (!order.sorted) {
+        rows.resize(keep);
+        return rows;
+    }
+
+    bool desc = order.descending;
+    if (const double* col = table.numeric(order.field)) {
+        // Sort (key, row) pairs so comparisons stay in one array; NaN last.
+        vector<pair<double, uint32_t>> keyed(rows.size());
+        for (size_t i = 0; i < rows.size(); i++) {
+            double v = col[rows[i]];
+            keyed[i] = {isnan(v) ? (desc ? -INFINITY : INFINITY) : v, rows[i]};
+        }
+        auto cmp = [desc](const pair<double, uint32_t>& a, const pair<double, uint32_t>& b) {
+            if (a.first != b.first) return desc ? a.first > b.first : a.first < b.first;
+            return a.second < b.second;
+        };
+        partial_sort(keyed.begin(), keyed.begin() + keep, keyed.end(), cmp);
+        for (size_t i = 0; i < keep; i++) rows[i] = keyed[i].second;
+    } else {
+        const vector<Stock>& s = *table.source;
+        auto text = [&](uint32_t r) -> const string& {
+            return order.field == SECTOR ? table.sectorNames[table.sector[r]]
+                 : order.field == SYMBOL ? s[r].symbol : s[r].name;
+        };
+        partial_sort(rows.begin(), rows.begin() + keep, rows.end(), [&](uint32_t a, uint32_t b) {
+            int c = text(a).compare(text(b));
+            if (c != 0) return desc ? c > 0 : c < 0;
+            return a < b;
+        });
+    }
+    rows.resize(keep);
+    return rows;
+}
+
+bool screen(const Table& table, const string& expr, const Order& order,
+            vector<uint32_t>& rows, size_t& matches, unsigned threads) {
+    static const HotStats::Histogram screenTime = HotStats::histogram(
+        "investedge_screen_seconds", "", "Time to compile, evaluate and sort a stock screen.");
+    HotStats::ScopedTimer timer(screenTime);
+
+    Screen s;
+    if (!s.compile(expr, table)) return false;
+    vector<uint64_t> bitmap = s.select(threads);
+    matches = countMatches(bitmap);
+    rows = orderMatches(table, bitmap, order);
+    return true;
+}
+
+void printMatches(const Table& table, const vector<uint32_t>& rows, size_t matches) {
+    cout << "\n" << matches << " of " << table.rows << " stocks match";
+    if (rows.size() < matches) cout << " (showing " << rows.size() << ")";
+    cout << "\n";
+    if (rows.empty()) return;
+
+    cout << "Symbol   | Name                 | Sector           |      Price |  Change |    Market Cap\n";
+    cout << "------------------------------------------------------------------------------------------\n";
+    const vector<Stock>& s = *table.source;
+    for (uint32_t r : rows) {
+        const Stock& st = s[r];
+        cout << left << setw(8) << st.symbol << " | "
+             << setw(20) << st.name.substr(0, 20) << " | "
+             << setw(16) << st.sector.substr(0, 16) << " | " << right
+             << fixed << setprecision(2) << setw(10) << st.price << " | "
+             << setw(6) << st.changePercent << "% | "
+             << setw(13) << st.marketCap << "\n";
+    }
+    cout << left;
+}
+
+} // namespace StockScreener
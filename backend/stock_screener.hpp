@@ -0,0 +1,100 @@
+// stock_screener.hpp
+// Filter expressions over the portfolio analyzer's stock universe, e.g.
+//   sector == "IT" && changePercent > 1.5 && marketCap > 1e6
+// An expression is compiled once against a column table, then evaluated
+// chunk by chunk into a selection bitmap (one bit per stock) across all
+// cores; matches can be sorted on any field and cut to a limit.
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "portfolio_analyzer.hpp"
+
+namespace StockScreener {
+
+/*===========================
+   Column Table
+===========================*/
+// Fields usable in expressions and sort keys. Names match the Stock members;
+// the CSV spellings (prev_close, market_cap) and any letter case work too.
+enum Field { PRICE, PREV_CLOSE, CHANGE_PERCENT, MARKET_CAP, SECTOR, SYMBOL, NAME, FIELD_COUNT };
+
+bool parseField(const std::string& name, Field& out);
+const char* fieldName(Field f);
+
+struct Table {
+    size_t rows = 0;
+    std::vector<double> price, prevClose, changePercent, marketCap;
+    std::vector<uint32_t> sector;                 // index into sectorNames
+    std::vector<std::string> sectorNames;
+    const std::vector<PortfolioAnalyzer::Stock>* source = nullptr;   // for symbol/name
+
+    const double* numeric(Field f) const;         // nullptr for text fields
+};
+
+// The table refers back to `stocks` for text fields; rebuild it when they change.
+Table buildTable(const std::vector<PortfolioAnalyzer::Stock>& stocks);
+
+/*===========================
+   Compiled Screen
+===========================*/
+// Grammar: comparisons `field op value` or `field op field` with
+// op in == != < <= > >= (text fields: == and != only, values in quotes),
+// combined with && || ! (or and/or/not) and parentheses. An empty
+// expression matches every stock.
+class Screen {
+public:
+    // Prints "Error: ..." and returns false on a syntax or type error.
+    bool compile(const std::string& expr, const Table& table);
+
+    // Bit i of the result is set when stock i matches (threads 0 = all cores).
+    std::vector<uint64_t> select(unsigned threads = 0) const;
+
+private:
+    enum Kind { NUM_CONST, NUM_FIELD, SECTOR_EQ, TEXT_EQ, AND, OR, NOT, ALL };
+    enum Op { EQ, NE, LT, LE, GT, GE };
+    struct Node {
+        Kind kind = ALL;
+        Op op = EQ;
+        Field field = PRICE, other = PRICE;
+        double value = 0;
+        uint32_t code = 0;            // sector code; UINT32_MAX = not in the table
+        std::string text;
+        int left = -1, right = -1;
+    };
+
+    const Table* table = nullptr;
+    std::vector<Node> nodes;
+    int root = -1;
+
+    void eval(int id, size_t begin, size_t end, uint64_t* out) const;
+    friend class Parser;
+};
+
+/*===========================
+   Sorting & Results
+===========================*/
+struct Order {
+    Field field = CHANGE_PERCENT;
+    bool sorted = false;              // false = universe order
+    bool descending = true;
+    size_t limit = 0;                 // 0 = every match
+};
+
+// "-changePercent" sorts descending, "marketCap" or "+marketCap" ascending.
+bool parseOrder(const std::string& spec, Order& out);
+
+size_t countMatches(const std::vector<uint64_t>& bitmap);
+
+// Matching row indices in the requested order, cut to order.limit.
+std::vector<uint32_t> orderMatches(const Table& table, const std::vector<uint64_t>& bitmap,
+                                   const Order& order);
+
+// compile + select + orderMatches; false on a bad expression.
+bool screen(const Table& table, const std::string& expr, const Order& order,
+            std::vector<uint32_t>& rows, size_t& matches, unsigned threads = 0);
+
+void printMatches(const Table& table, const std::vector<uint32_t>& rows, size_t matches);
+
+} // namespace StockScreener
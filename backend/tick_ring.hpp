@@ -0,0 +1,336 @@
+// tick_ring.hpp
+// Lock-free single-producer / multi-consumer broadcast ring in POSIX shared
+// memory. The tracker process publishes fixed-size tick and stats records;
+// any number of local readers attach read-only and follow the stream at
+// their own pace. The producer never waits for readers: a reader that falls
+// more than `capacity` records behind is told how many it lost and resyncs.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace TickRing {
+
+/*===========================
+   Record Layout
+===========================*/
+// Producers publish a KIND_TICK and then a KIND_STATS record for every
+// price, so a consumer counting or applying prices must filter on `kind`.
+enum RecordKind : uint32_t {
+    KIND_TICK  = 1,   // price only
+    KIND_STATS = 2    // price + rolling min/max/avg
+};
+
+struct Record {
+    int64_t  tsNanos;     // steady clock, comparable across local processes
+    uint32_t kind;
+    char     symbol[12];  // NUL-padded, truncated to 11 chars
+    double   price, min, max, avg;
+};
+static_assert(sizeof(Record) == 56, "Record must stay 56 bytes");
+
+constexpr size_t RECORD_WORDS = sizeof(Record) / sizeof(uint64_t);
+
+// One cache line per slot: the commit sequence followed by the payload.
+// The payload is stored as relaxed atomic words so a reader racing the
+// producer sees a torn record (caught by the sequence check), never UB.
+struct alignas(64) Slot {
+    std::atomic<uint64_t> seq;               // n + 1 once record n is complete, 0 while writing
+    std::atomic<uint64_t> words[RECORD_WORDS];
+};
+static_assert(sizeof(Slot) == 64, "Slot must be one cache line");
+
+constexpr uint64_t RING_MAGIC   = 0x474e495245444745ull; // "EDGERING"
+constexpr uint32_t RING_VERSION = 1;
+
+struct alignas(64) Header {
+    std::atomic<uint64_t> magic;     // written last by the producer
+    uint32_t version;
+    uint32_t slotSize;
+    uint64_t capacity;               // power of two
+    alignas(64) std::atomic<uint64_t> head;  // records published so far
+};
+
+inline size_t mappingSize(uint64_t capacity) {
+    return sizeof(Header) + capacity * sizeof(Slot);
+}
+
+inline int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline void setSymbol(Record& r, const std::string& sym) {
+    std::memset(r.symbol, 0, sizeof(r.symbol));
+    std::memcpy(r.symbol, sym.data(), std::min(sym.size(), sizeof(r.symbol) - 1));
+}
+
+// Default segment name for a module, overridable with INVESTEDGE_TICK_RING.
+inline std::string defaultName(const std::string& module) {
+    const char* env = std::getenv("INVESTEDGE_TICK_RING");
+    return env && *env ? std::string(env) : "/investedge_" + module;
+}
+
+// True while a producer is publishing to the segment: it holds an exclusive
+// flock on it from open() until close() or exit, so a probe for a shared
+// lock is refused. The probe's own lock goes with its fd at once.
+inline bool hasProducer(const std::string& shmName) {
+    int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    bool held = flock(fd, LOCK_SH | LOCK_NB) != 0 && errno == EWOULDBLOCK;
+    ::close(fd);
+    return held;
+}
+
+// Names ("/investedge_...") of the segments in /dev/shm with a live producer.
+inline std::vector<std::string> liveRings() {
+    std::vector<std::string> out;
+    DIR* dir = opendir("/dev/shm");
+    if (!dir) return out;
+    while (dirent* e = readdir(dir)) {
+        std::string name = std::string("/") + e->d_name;
+        if (name.compare(0, 12, "/investedge_") == 0 && hasProducer(name)) out.push_back(name);
+    }
+    closedir(dir);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+/*===========================
+   Producer
+===========================*/
+class Producer {
+private:
+    Header* hdr = nullptr;
+    Slot* slots = nullptr;
+    uint64_t mask = 0;
+    uint64_t next = 0;
+    size_t bytes = 0;
+    int lockFd = -1;                 // holds the writer lock while open
+    std::string name;
+
+public:
+    Producer() = default;
+    Producer(const Producer&) = delete;
+    Producer& operator=(const Producer&) = delete;
+    ~Producer() { close(); }
+
+    // Creates (or recreates) the segment. Capacity is rounded up to a power of two.
+    // Fails while another live producer has the same segment open: the ring
+    // has a single writer, and resetting it under one would rewind its head.
+    bool open(const std::string& shmName, uint64_t capacity = 1 << 16) {
+        close();
+        uint64_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+
+        int fd = shm_open(shmName.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0) return false;
+        if (flock(fd, LOCK_EX | LOCK_NB) != 0) { ::close(fd); return false; }
+        bytes = mappingSize(cap);
+        if (ftruncate(fd, (off_t)bytes) != 0) { ::close(fd); return false; }
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) { ::close(fd); return false; }
+        lockFd = fd;                 // the lock goes with the fd, released on close()
+
+        name = shmName;
+        hdr = static_cast<Header*>(p);
+        slots = reinterpret_cast<Slot*>(static_cast<char*>(p) + sizeof(Header));
+        mask = cap - 1;
+        next = 0;
+
+        // Invalidate any reader still attached to a previous incarnation.
+        hdr->magic.store(0, std::memory_order_relaxed);
+        hdr->version = RING_VERSION;
+        hdr->slotSize = sizeof(Slot);
+        hdr->capacity = cap;
+        hdr->head.store(0, std::memory_order_relaxed);
+        for (uint64_t i = 0; i < cap; i++) slots[i].seq.store(0, std::memory_order_relaxed);
+        hdr->magic.store(RING_MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    void close() {
+        if (!hdr) return;
+        munmap(hdr, bytes);
+        hdr = nullptr;
+        slots = nullptr;
+        ::close(lockFd);
+        lockFd = -1;
+    }
+
+    // Removes the segment name; attached readers keep their mapping.
+    void unlink() {
+        if (!name.empty()) shm_unlink(name.c_str());
+    }
+
+    bool isOpen() const { return hdr != nullptr; }
+    uint64_t published() const { return next; }
+
+    void publish(const Record& r) {
+        if (!hdr) return;
+        Slot& s = slots[next & mask];
+        uint64_t w[RECORD_WORDS];
+        std::memcpy(w, &r, sizeof(r));
+
+        s.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < RECORD_WORDS; i++)
+            s.words[i].store(w[i], std::memory_order_relaxed);
+        s.seq.store(next + 1, std::memory_order_release);
+
+        next++;
+        hdr->head.store(next, std::memory_order_release);
+    }
+
+    void publishTick(const std::string& symbol, double price) {
+        Record r{};
+        r.tsNanos = nowNanos();
+        r.kind = KIND_TICK;
+        setSymbol(r, symbol);
+        r.price = price;
+        publish(r);
+    }
+
+    void publishStats(const std::string& symbol, double price,
+                      double min, double max, double avg) {
+        Record r{};
+        r.tsNanos = nowNanos();
+        r.kind = KIND_STATS;
+        setSymbol(r, symbol);
+        r.price = price;
+        r.min = min;
+        r.max = max;
+        r.avg = avg;
+        publish(r);
+    }
+};
+
+/*===========================
+   Consumer
+===========================*/
+class Consumer {
+private:
+    const Header* hdr = nullptr;
+    const Slot* slots = nullptr;
+    uint64_t capacity = 0;
+    uint64_t cursor = 0;
+    uint64_t lostCount = 0;
+    size_t bytes = 0;
+
+public:
+    Consumer() = default;
+    Consumer(const Consumer&) = delete;
+    Consumer& operator=(const Consumer&) = delete;
+    ~Consumer() { close(); }
+
+    // Attaches read-only. With fromStart=false only records published after
+    // attach are delivered; otherwise the oldest record still in the ring.
+    bool open(const std::string& shmName, bool fromStart = false) {
+        close();
+        int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Header)) { ::close(fd); return false; }
+        bytes = (size_t)st.st_size;
+        void* p = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        hdr = static_cast<const Header*>(p);
+        if (hdr->magic.load(std::memory_order_acquire) != RING_MAGIC ||
+            hdr->version != RING_VERSION || hdr->slotSize != sizeof(Slot) ||
+            mappingSize(hdr->capacity) > bytes) {
+            close();
+            return false;
+        }
+        slots = reinterpret_cast<const Slot*>(static_cast<const char*>(p) + sizeof(Header));
+        capacity = hdr->capacity;
+        uint64_t h = hdr->head.load(std::memory_order_acquire);
+        cursor = fromStart ? (h > capacity ? h - capacity : 0) : h;
+        lostCount = 0;
+        return true;
+    }
+
+    void close() {
+        if (!hdr) return;
+        munmap(const_cast<Header*>(hdr), bytes);
+        hdr = nullptr;
+        slots = nullptr;
+    }
+
+    bool isOpen() const { return hdr != nullptr; }
+
+    // True once the producer has recreated the segment; reopen to follow it.
+    bool isStale() const {
+        return !hdr || hdr->magic.load(std::memory_order_relaxed) != RING_MAGIC ||
+               hdr->head.load(std::memory_order_relaxed) < cursor;
+    }
+
+    uint64_t position() const { return cursor; }
+    uint64_t lost() const { return lostCount; }   // records overrun so far
+    uint64_t backlog() const {
+        return hdr ? hdr->head.load(std::memory_order_acquire) - cursor : 0;
+    }
+
+    // Reads the next record into `out`. Returns false when caught up.
+    // Overruns are skipped and added to lost().
+    bool next(Record& out) {
+        if (!hdr) return false;
+        while (true) {
+            uint64_t h = hdr->head.load(std::memory_order_acquire);
+            if (cursor >= h) return false;
+            if (h - cursor > capacity) {
+                lostCount += h - capacity - cursor;
+                cursor = h - capacity;
+            }
+
+            const Slot& s = slots[cursor & (capacity - 1)];
+            uint64_t s1 = s.seq.load(std::memory_order_acquire);
+            if (s1 == cursor + 1) {
+                uint64_t w[RECORD_WORDS];
+                for (size_t i = 0; i < RECORD_WORDS; i++)
+                    w[i] = s.words[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.seq.load(std::memory_order_relaxed) == s1) {
+                    std::memcpy(&out, w, sizeof(out));
+                    cursor++;
+                    return true;
+                }
+            }
+            // Slot already reused (or being rewritten) by the producer:
+            // we were lapped. Jump to the oldest record that is still valid.
+            uint64_t h2 = hdr->head.load(std::memory_order_acquire);
+            uint64_t oldest = h2 > capacity ? h2 - capacity + 1 : 0;
+            if (oldest <= cursor) oldest = cursor + 1;
+            lostCount += oldest - cursor;
+            cursor = oldest;
+        }
+    }
+
+    // Drains everything currently available into fn(const Record&).
+    template <typename Fn>
+    size_t poll(Fn&& fn, size_t maxRecords = SIZE_MAX) {
+        Record r;
+        size_t n = 0;
+        while (n < maxRecords && next(r)) {
+            fn(r);
+            n++;
+        }
+        return n;
+    }
+};
+
+} // namespace TickRing
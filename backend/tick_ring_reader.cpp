@@ -0,0 +1,87 @@
+// tick_ring_reader.cpp
+// Follows a tracker's shared-memory tick ring and re-emits each record as
+// one JSON line on stdout. server.js runs a single reader per ring and fans
+// the lines out to every connected socket.
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "tick_ring.hpp"
+
+using namespace std;
+
+namespace TickRingReader {
+
+    // ======== RECORD → JSON LINE ========
+    // Symbols come from whatever the producer was asked to track, so quote
+    // them properly; NaN/inf (e.g. stats of an empty window) become null.
+    static void writeString(ostream& out, const char* s, size_t n) {
+        out << '"';
+        for (size_t i = 0; i < n; i++) {
+            unsigned char c = (unsigned char)s[i];
+            if (c == '"' || c == '\\') out << '\\' << (char)c;
+            else if (c < 0x20) {
+                char esc[8];
+                snprintf(esc, sizeof(esc), "\\u%04x", c);
+                out << esc;
+            }
+            else out << (char)c;
+        }
+        out << '"';
+    }
+
+    static void writeNumber(ostream& out, double v) {
+        if (isfinite(v)) out << v;
+        else out << "null";
+    }
+
+    void writeRecord(ostream& out, const TickRing::Record& r) {
+        out << "{\"kind\":\"" << (r.kind == TickRing::KIND_STATS ? "stats" : "tick") << "\""
+            << ",\"symbol\":";
+        writeString(out, r.symbol, strnlen(r.symbol, sizeof(r.symbol)));
+        out << ",\"ts\":" << r.tsNanos << ",\"price\":";
+        writeNumber(out, r.price);
+        if (r.kind == TickRing::KIND_STATS) {
+            out << ",\"min\":";
+            writeNumber(out, r.min);
+            out << ",\"max\":";
+            writeNumber(out, r.max);
+            out << ",\"avg\":";
+            writeNumber(out, r.avg);
+        }
+        out << "}\n";
+    }
+
+    // ======== MODULE ENTRY POINT ========
+    void run(const string& ringName) {
+        TickRing::Consumer consumer;
+        uint64_t reportedLost = 0;
+        cout << fixed << setprecision(4);
+
+        while (true) {
+            if (!consumer.isOpen() || consumer.isStale()) {
+                if (!consumer.open(ringName)) {
+                    this_thread::sleep_for(chrono::milliseconds(500));
+                    continue;
+                }
+                reportedLost = 0;
+                cerr << "Attached to " << ringName << "\n";
+            }
+
+            size_t n = consumer.poll([](const TickRing::Record& r) { writeRecord(cout, r); });
+
+            if (consumer.lost() != reportedLost) {
+                cout << "{\"kind\":\"lost\",\"count\":" << consumer.lost() - reportedLost << "}\n";
+                reportedLost = consumer.lost();
+            }
+
+            if (n > 0) cout.flush();
+            else this_thread::sleep_for(chrono::milliseconds(5));
+        }
+    }
+
+} // namespace TickRingReader
@@ -5,6 +5,21 @@ import logoUrl from './ui/logo.svg'
 import { io } from 'socket.io-client'
 
 const SERVER_URL = 'http://localhost:5055'
+const QUOTE_REFRESH_MS = 250
+
+// Folds one tick-ring record into the per-symbol quotes. Trackers publish a
+// 'tick' and then a 'stats' record per price: only ticks are counted, and
+// stats fill in the rolling min/max/avg.
+function applyRecord(quotes, r) {
+  quotes.dirty = true
+  if (r.kind === 'lost') { quotes.lost += r.count; return }
+  const q = quotes.bySymbol[r.symbol] ?? (quotes.bySymbol[r.symbol] = { updates: 0 })
+  q.price = r.price
+  if (r.kind === 'tick') q.updates++
+  else if (r.kind === 'stats') { q.min = r.min; q.max = r.max; q.avg = r.avg }
+}
+
+const fmt = v => (typeof v === 'number' ? v.toFixed(2) : '–')
 
 export default function InvestEdge() {
   const [socket, setSocket] = useState(null)
@@ -12,7 +27,9 @@ export default function InvestEdge() {
   const [status, setStatus] = useState('Idle')
   const [pick, setPick] = useState('profit_loss')
   const [log, setLog] = useState('')
+  const [quotes, setQuotes] = useState({ bySymbol: {}, lost: 0 })
   const inputRef = useRef(null)
+  const pendingQuotes = useRef({ bySymbol: {}, lost: 0 })
 
   useEffect(() => {
     const s = io(SERVER_URL, { transports: ['websocket'] })
@@ -23,10 +40,22 @@ export default function InvestEdge() {
     s.on('stderr', chunk => setLog(p => p + chunk))
     s.on('status', msg => { setStatus(msg); setLog(p => p + `\n[STATUS] ${msg}\n`) })
     s.on('errorMsg', msg => setLog(p => p + `\n[ERROR] ${msg}\n`) )
-    return () => s.disconnect()
+    // A busy feed sends thousands of records a second: fold them into a ref
+    // and re-render the quotes panel a few times a second.
+    s.on('ticks', records => records.forEach(r => applyRecord(pendingQuotes.current, r)))
+    const timer = setInterval(() => {
+      const q = pendingQuotes.current
+      if (!q.dirty) return
+      q.dirty = false
+      setQuotes({ bySymbol: { ...q.bySymbol }, lost: q.lost })
+    }, QUOTE_REFRESH_MS)
+    return () => { clearInterval(timer); s.disconnect() }
   }, [])
 
-  const start = () => socket?.emit('start', { appName: pick })
+  const start = () => {
+    pendingQuotes.current = { bySymbol: {}, lost: 0, dirty: true }
+    socket?.emit('start', { appName: pick })
+  }
   const stop = () => socket?.emit('stop')
   const send = () => {
     const v = inputRef.current?.value ?? ''
@@ -92,6 +121,9 @@ export default function InvestEdge() {
                 <option value="stock_news">Stock News</option>
                 <option value="risk_management">Risk Management</option>
                 <option value="portfolio_analyzer">Portfolio Analyzer</option>
+                <option value="portfolio_optimizer">Portfolio Optimizer</option>
+                <option value="mark_to_market">Mark to Market</option>
+                <option value="price_stream">Streaming Prices</option>
               </select>
             </div>
 
@@ -155,6 +187,41 @@ export default function InvestEdge() {
           </div>
         </section>
 
+        {/* ------------------ Live Prices (tick ring) ------------------ */}
+        {Object.keys(quotes.bySymbol).length > 0 && (
+          <section style={{ marginTop: 24 }} className="panel">
+            <div className="title">
+              Live Prices{quotes.lost > 0 ? ` (${quotes.lost} records dropped by a slow reader)` : ''}
+            </div>
+            <table style={{ width: '100%', color: '#cbd5e1', fontSize: 13, borderCollapse: 'collapse' }}>
+              <thead>
+                <tr style={{ color: '#9fb0ff', textAlign: 'right' }}>
+                  <th style={{ textAlign: 'left' }}>Symbol</th>
+                  <th>Price</th>
+                  <th>Min</th>
+                  <th>Max</th>
+                  <th>Avg</th>
+                  <th>Updates</th>
+                </tr>
+              </thead>
+              <tbody>
+                {Object.entries(quotes.bySymbol)
+                  .sort(([a], [b]) => a.localeCompare(b))
+                  .map(([sym, q]) => (
+                    <tr key={sym} style={{ textAlign: 'right' }}>
+                      <td style={{ textAlign: 'left' }}>{sym}</td>
+                      <td>{fmt(q.price)}</td>
+                      <td>{fmt(q.min)}</td>
+                      <td>{fmt(q.max)}</td>
+                      <td>{fmt(q.avg)}</td>
+                      <td>{q.updates}</td>
+                    </tr>
+                  ))}
+              </tbody>
+            </table>
+          </section>
+        )}
+
         {/* ------------------ Info Panels ------------------ */}
         <section style={{ marginTop: 24 }} className="grid-2">
           <div className="panel">